@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Drives the processor's faster paths with randomized settings, sample rates,
+    block sizes and automation, and fails where they stray from the reference.
+
+  ==============================================================================
+*/
+
+#include "../../Source/PluginProcessor.h"
+#include "../../Tools/ToolSupport.h"
+#include <JuceHeader.h>
+#include <iostream>
+
+#if !SIMPLEEQ_VERIFY_FAST_PATHS
+#error "The harness needs the processor built with SIMPLEEQ_VERIFY_FAST_PATHS=1"
+#endif
+
+namespace {
+struct Options {
+    int numRuns{20};
+    double seconds{10}; // of audio per run, long enough to see the state drift
+    juce::int64 seed{1};
+    bool automate{true};
+    bool verbose{false};
+};
+
+// the odd ones as some hosts use, the small ones to update often
+constexpr int blockSizes[] = {16, 64, 128, 256, 441, 512, 1024, 2048};
+
+// the parameters automation moves, the main chain's and the side chain's
+constexpr Param automatedParams[] = {Param::LowCutFreq,      Param::HighCutFreq,
+                                     Param::PeakFreq,        Param::PeakGain,
+                                     Param::PeakQuality,     Param::SideLowCutFreq,
+                                     Param::SideHighCutFreq, Param::SidePeakFreq,
+                                     Param::SidePeakGain,    Param::SidePeakQuality};
+constexpr Param slopeParams[] = {Param::LowCutSlope, Param::HighCutSlope, Param::SideLowCutSlope,
+                                 Param::SideHighCutSlope};
+
+// the settings of the chains themselves, everything but the mode and topology
+constexpr Param chainParams[] = {
+    Param::LowCutFreq,      Param::HighCutFreq,     Param::PeakFreq,
+    Param::PeakGain,        Param::PeakQuality,     Param::LowCutSlope,
+    Param::HighCutSlope,    Param::SideLowCutFreq,  Param::SideHighCutFreq,
+    Param::SidePeakFreq,    Param::SidePeakGain,    Param::SidePeakQuality,
+    Param::SideLowCutSlope, Param::SideHighCutSlope,
+};
+
+// as a host's automation does it, before the block
+void setParameter(SimpleEQAudioProcessor &processor, Param param, float normalisedValue) {
+    auto *parameter = processor.apvts.getParameter(getParamID(param));
+    parameter->setValueNotifyingHost(juce::jlimit(0.f, 1.f, normalisedValue));
+}
+
+void setChoice(SimpleEQAudioProcessor &processor, Param param, int index) {
+    auto *parameter = processor.apvts.getParameter(getParamID(param));
+    parameter->setValueNotifyingHost(parameter->convertTo0to1((float)index));
+}
+
+struct Run {
+    double sampleRate;
+    int maxBlockSize;
+    bool varyBlockSize;
+    StereoMode stereoMode;
+    FilterTopology topology;
+
+    juce::String describe() const {
+        return juce::String(juce::roundToInt(sampleRate)) + " Hz, blocks of " +
+               (varyBlockSize ? "up to " : "") + juce::String(maxBlockSize) + ", " +
+               stereoModeChoices[(int)stereoMode] + ", " + topologyChoices[(int)topology];
+    }
+};
+
+// Returns true if the faster paths stayed within the verifier's tolerances.
+bool runOnce(const Options &options, const Run &run, juce::Random &random) {
+    auto processor = std::make_unique<SimpleEQAudioProcessor>();
+
+    for (auto param : chainParams) setParameter(*processor, param, random.nextFloat());
+    setChoice(*processor, Param::StereoMode, (int)run.stereoMode);
+    setChoice(*processor, Param::FilterTopology, (int)run.topology);
+
+    processor->setRateAndBufferSizeDetails(run.sampleRate, run.maxBlockSize);
+    processor->prepareToPlay(run.sampleRate, run.maxBlockSize);
+
+    juce::AudioBuffer<float> buffer(2, run.maxBlockSize);
+    juce::MidiBuffer midi;
+    auto numSamples = juce::roundToInt(options.seconds * run.sampleRate);
+
+    for (int position = 0; position < numSamples;) {
+        auto blockSize = run.maxBlockSize;
+        if (run.varyBlockSize) blockSize = 1 + random.nextInt(run.maxBlockSize);
+        blockSize = juce::jmin(blockSize, numSamples - position);
+
+        if (options.automate) {
+            // small moves most blocks, a jump of a slope now and then
+            for (auto param : automatedParams) {
+                if (random.nextInt(8) != 0) continue;
+                auto *parameter = processor->apvts.getParameter(getParamID(param));
+                setParameter(*processor, param,
+                             parameter->getValue() + (random.nextFloat() - 0.5f) * 0.01f);
+            }
+            // every 4 seconds on average whatever the block size, as the verifier lets
+            // each settle for a while
+            if (random.nextDouble() < blockSize / (4 * run.sampleRate))
+                setChoice(*processor, slopeParams[random.nextInt((int)std::size(slopeParams))],
+                          random.nextInt(4));
+            if (random.nextInt(2000) == 0)
+                processor->setCurrentProgram(random.nextInt(processor->getNumPrograms()));
+        }
+
+        // white noise, different on each channel so that side isn't silent
+        buffer.setSize(2, blockSize, false, false, true);
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+        processor->processBlock(buffer, midi);
+        position += blockSize;
+    }
+
+    auto &verifier = processor->getPathVerifier();
+    verifier.finish();
+    auto passed = !verifier.hasFailed();
+
+    std::cout << (passed ? "passed  " : "FAILED  ") << run.describe() << std::endl;
+    if (!passed || options.verbose) std::cout << verifier.getReport() << std::endl;
+    return passed;
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "SimpleEQAccuracyHarness [--runs=N] [--seconds=N] [--seed=N] "
+                     "[--no-automation] [--verbose]\n"
+                     "Runs the processor against the reference chain with random settings, "
+                     "and exits with 1 if any run goes past the tolerances."
+                  << std::endl;
+        return 0;
+    }
+
+    Options options;
+    options.numRuns = getIntOption(args, "--runs", options.numRuns);
+    options.seconds = getDoubleOption(args, "--seconds", options.seconds);
+    if (args.containsOption("--seed"))
+        options.seed = args.getValueForOption("--seed").getLargeIntValue();
+    options.automate = !args.containsOption("--no-automation");
+    options.verbose = args.containsOption("--verbose");
+
+    juce::Random random(options.seed);
+    int numFailed = 0;
+    for (int i = 0; i < options.numRuns; ++i) {
+        Run run;
+        run.sampleRate = sampleRates[random.nextInt((int)std::size(sampleRates))];
+        run.maxBlockSize = blockSizes[random.nextInt((int)std::size(blockSizes))];
+        run.varyBlockSize = random.nextBool();
+        run.stereoMode = (StereoMode)random.nextInt((int)std::size(stereoModeChoices));
+        run.topology = (FilterTopology)random.nextInt((int)std::size(topologyChoices));
+
+        if (!runOnce(options, run, random)) ++numFailed;
+    }
+
+    std::cout << numFailed << " of " << options.numRuns << " runs failed" << std::endl;
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Hosts many SimpleEQ processors across worker threads, with automation, and
+    finds how many of them still meet the realtime deadline.
+
+  ==============================================================================
+*/
+
+#include "../../Source/ParallelChannelRenderer.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Tools/ToolSupport.h"
+#include <JuceHeader.h>
+#include <cstdio>
+#include <iostream>
+
+#if JUCE_LINUX
+#include <unistd.h>
+#elif JUCE_WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#endif
+
+namespace {
+struct Options {
+    int numThreads{juce::SystemStats::getNumCpus()};
+    int blockSize{128};
+    double sampleRate{48000};
+    double seconds{5}; // of audio per run
+};
+
+// the parameters hosts automate most, moved a little at a time
+constexpr Param automatedParams[] = {Param::LowCutFreq, Param::HighCutFreq, Param::PeakFreq,
+                                     Param::PeakGain, Param::PeakQuality};
+
+struct Instance {
+    std::unique_ptr<SimpleEQAudioProcessor> processor;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+    juce::Random random;
+    std::array<juce::AudioProcessorParameter *, std::size(automatedParams)> automated{};
+
+    void prepare(const Options &options, int index) {
+        processor = std::make_unique<SimpleEQAudioProcessor>();
+        processor->setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+        processor->prepareToPlay(options.sampleRate, options.blockSize);
+        buffer.setSize(2, options.blockSize);
+        random.setSeed(index);
+
+        for (size_t i = 0; i < automated.size(); ++i)
+            automated[i] = processor->apvts.getParameter(getParamID(automatedParams[i]));
+    }
+
+    // what a host does with a block's automation, before processBlock()
+    void automate() {
+        for (auto *parameter : automated) {
+            if (random.nextInt(4) != 0) continue;
+
+            auto value = parameter->getValue() + (random.nextFloat() - 0.5f) * 0.02f;
+            value = juce::jlimit(0.f, 1.f, value);
+            parameter->setValue(value);
+            parameter->sendValueChangedMessageToListeners(value);
+        }
+    }
+};
+
+juce::int64 getResidentBytes() {
+#if JUCE_LINUX
+    long pages = 0, residentPages = 0;
+    if (auto *statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%ld %ld", &pages, &residentPages) != 2) residentPages = 0;
+        std::fclose(statm);
+    }
+    return (juce::int64)residentPages * sysconf(_SC_PAGESIZE);
+#elif JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return (juce::int64)counters.WorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
+struct RunResult {
+    int numInstances;
+    Percentiles periods, blocks; // in ms
+    bool meetsDeadline;
+};
+
+// Every period, the workers and the calling thread take the instances one at a time
+// until all of them have processed a block, as a host's worker threads do. Periods
+// run back to back, the deadline is a block's duration.
+RunResult run(const Options &options, int numInstances) {
+    std::vector<Instance> instances((size_t)numInstances);
+    for (int i = 0; i < numInstances; ++i) instances[(size_t)i].prepare(options, i);
+
+    juce::AudioBuffer<float> noise(2, options.blockSize);
+    juce::Random random(1);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < options.blockSize; ++i)
+            noise.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+    auto numPeriods = juce::jmax(1, juce::roundToInt(options.seconds * options.sampleRate /
+                                                     options.blockSize));
+    std::vector<double> periodTimes((size_t)numPeriods);
+    std::vector<double> blockTimes((size_t)numPeriods * (size_t)numInstances);
+    int period = 0;
+
+    auto processInstance = [&](int index) {
+        auto &instance = instances[(size_t)index];
+        instance.automate();
+        for (int channel = 0; channel < 2; ++channel)
+            instance.buffer.copyFrom(channel, 0, noise, channel, 0, options.blockSize);
+
+        blockTimes[(size_t)period * (size_t)numInstances + (size_t)index] = timeMilliseconds(
+            [&] { instance.processor->processBlock(instance.buffer, instance.midi); });
+    };
+
+    ParallelChannelRenderer renderer;
+    renderer.start(options.numThreads - 1);
+
+    for (period = 0; period < numPeriods; ++period) {
+        periodTimes[(size_t)period] =
+            timeMilliseconds([&] { renderer.run(numInstances, processInstance); });
+    }
+    renderer.stop();
+
+    auto deadline = 1000.0 * options.blockSize / options.sampleRate;
+    RunResult result{numInstances, Percentiles(periodTimes), Percentiles(blockTimes), false};
+    result.meetsDeadline = result.periods.p999 <= deadline;
+    return result;
+}
+
+void print(const RunResult &result) {
+    auto column = [](double value) { return juce::String(value, 3).paddedLeft(' ', 9); };
+    std::cout << juce::String(result.numInstances).paddedLeft(' ', 9)
+              << column(result.periods.p50) << column(result.periods.p99)
+              << column(result.periods.p999) << column(result.periods.max)
+              << column(result.blocks.p50 * 1000) << column(result.blocks.p99 * 1000)
+              << column(result.blocks.p999 * 1000) << column(result.blocks.max * 1000) << "  "
+              << (result.meetsDeadline ? "meets" : "misses") << std::endl;
+}
+
+// The growth of the process' resident memory, the first thing the process does so
+// that nothing freed before is reused.
+void printMemoryPerInstance(const Options &options, int numInstances) {
+    auto before = getResidentBytes();
+    std::vector<Instance> instances((size_t)numInstances);
+    for (int i = 0; i < numInstances; ++i) {
+        auto &instance = instances[(size_t)i];
+        instance.prepare(options, i);
+        instance.processor->processBlock(instance.buffer, instance.midi);
+    }
+    auto bytesPerInstance = double(getResidentBytes() - before) / numInstances;
+
+    std::cout << "sizeof(SimpleEQAudioProcessor): " << sizeof(SimpleEQAudioProcessor)
+              << " bytes, cache line separation: "
+              << (SIMPLEEQ_SEPARATE_CACHE_LINES ? "on" : "off") << std::endl;
+    std::cout << "resident memory per instance (" << numInstances
+              << " instances): " << juce::String(bytesPerInstance / 1024.0, 1) << " kB"
+              << std::endl;
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "SimpleEQLoadTest [--threads=N] [--block=N] [--rate=N] [--seconds=N] "
+                     "[--instances=N]\n"
+                     "Without --instances, searches for the most instances that meet the "
+                     "deadline in 99.9% of the periods."
+                  << std::endl;
+        return 0;
+    }
+
+    Options options;
+    options.numThreads = getIntOption(args, "--threads", options.numThreads);
+    options.blockSize = getIntOption(args, "--block", options.blockSize);
+    options.sampleRate = getDoubleOption(args, "--rate", options.sampleRate);
+    options.seconds = getDoubleOption(args, "--seconds", options.seconds);
+    auto fixedInstances = getIntOption(args, "--instances", 0);
+
+    std::cout << options.numThreads << " threads, " << options.blockSize << " samples at "
+              << options.sampleRate << " Hz, deadline "
+              << juce::String(1000.0 * options.blockSize / options.sampleRate, 3) << " ms"
+              << std::endl;
+    printMemoryPerInstance(options, fixedInstances > 0 ? fixedInstances : 64);
+
+    std::cout << "instances   period ms: p50      p99    p99.9      max   block us: p50      "
+                 "p99    p99.9      max"
+              << std::endl;
+
+    if (fixedInstances > 0) {
+        auto result = run(options, fixedInstances);
+        print(result);
+        return result.meetsDeadline ? 0 : 1;
+    }
+
+    // doubling until a run misses the deadline, then bisecting to within 5 %
+    constexpr int maxInstances = 4096;
+    int meets = 0, misses = 0;
+    for (int n = 16; n <= maxInstances && misses == 0; n *= 2) {
+        auto result = run(options, n);
+        print(result);
+        (result.meetsDeadline ? meets : misses) = n;
+    }
+
+    if (misses == 0) {
+        std::cout << "all " << meets << " instances meet the deadline" << std::endl;
+        return 0;
+    }
+
+    while (misses - meets > juce::jmax(1, meets / 20)) {
+        auto n = (meets + misses) / 2;
+        auto result = run(options, n);
+        print(result);
+        (result.meetsDeadline ? meets : misses) = n;
+    }
+
+    std::cout << "max instances meeting the deadline: " << meets << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    BiquadDesigner.cpp
+    Closed form design of the chain's coefficients, without allocating.
+
+  ==============================================================================
+*/
+
+#include "BiquadDesigner.h"
+
+static BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1,
+                                    double a2) noexcept {
+    auto a0Inverse = 1.0 / a0;
+    return {float(b0 * a0Inverse), float(b1 * a0Inverse), float(b2 * a0Inverse),
+            float(a1 * a0Inverse), float(a2 * a0Inverse)};
+}
+
+// the bilinear transforms of IIR::Coefficients::makeHighPass() and makeLowPass()
+static BiquadCoefficients designHighPass(double sampleRate, double freq, double quality) noexcept {
+    auto n = std::tan(juce::MathConstants<double>::pi * freq / sampleRate);
+    auto nSquared = n * n;
+    auto invQ = 1.0 / quality;
+    auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return normalise(c1, c1 * -2.0, c1, 1.0, c1 * 2.0 * (nSquared - 1.0),
+                     c1 * (1.0 - invQ * n + nSquared));
+}
+
+static BiquadCoefficients designLowPass(double sampleRate, double freq, double quality) noexcept {
+    auto n = 1.0 / std::tan(juce::MathConstants<double>::pi * freq / sampleRate);
+    auto nSquared = n * n;
+    auto invQ = 1.0 / quality;
+    auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return normalise(c1, c1 * 2.0, c1, 1.0, c1 * 2.0 * (1.0 - nSquared),
+                     c1 * (1.0 - invQ * n + nSquared));
+}
+
+BiquadCoefficients designPeak(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    // RBJ's peaking EQ, as IIR::Coefficients::makePeakFilter()
+    auto gainFactor = juce::Decibels::decibelsToGain((double)chainSettings.peakGainInDecibels);
+    auto a = std::sqrt(gainFactor);
+    auto omega = juce::MathConstants<double>::twoPi * chainSettings.peakFreq / sampleRate;
+    auto alpha = std::sin(omega) / (chainSettings.peakQuality * 2.0);
+    auto c2 = -2.0 * std::cos(omega);
+    auto alphaTimesA = alpha * a;
+    auto alphaOverA = alpha / a;
+
+    return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA, 1.0 + alphaOverA, c2,
+                     1.0 - alphaOverA);
+}
+
+CutDesign designLowCut(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    CutDesign design;
+    design.numSections = chainSettings.lowCutSlope + 1;
+    for (int i = 0; i < design.numSections; ++i)
+        design.sections[(size_t)i] =
+            designHighPass(sampleRate, chainSettings.lowCutFreq,
+                           getButterworthQuality(2 * design.numSections, i));
+    return design;
+}
+
+CutDesign designHighCut(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    CutDesign design;
+    design.numSections = chainSettings.highCutSlope + 1;
+    for (int i = 0; i < design.numSections; ++i)
+        design.sections[(size_t)i] =
+            designLowPass(sampleRate, chainSettings.highCutFreq,
+                          getButterworthQuality(2 * design.numSections, i));
+    return design;
+}
+
+//==============================================================================
+void setCoefficients(Filter &filter, const BiquadCoefficients &coefficients) {
+    auto &dst = filter.coefficients->coefficients;
+    if (dst.size() != (int)coefficients.size()) dst.resize((int)coefficients.size());
+    std::copy(coefficients.begin(), coefficients.end(), dst.begin());
+}
+
+template <int Index> static void setSection(CutFilter &cut, const CutDesign &design) {
+    setCoefficients(cut.get<Index>(), design.sections[Index]);
+    cut.setBypassed<Index>(false);
+}
+
+void setCutCoefficients(CutFilter &cut, const CutDesign &design) {
+    cut.setBypassed<0>(true);
+    cut.setBypassed<1>(true);
+    cut.setBypassed<2>(true);
+    cut.setBypassed<3>(true);
+    switch (design.numSections) {
+    case 4:
+        setSection<3>(cut, design);
+    case 3:
+        setSection<2>(cut, design);
+    case 2:
+        setSection<1>(cut, design);
+    case 1:
+        setSection<0>(cut, design);
+        break;
+    }
+}
@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    BiquadDesigner.h
+    Closed form design of the chain's coefficients, without allocating.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FilterChain.h"
+#include <JuceHeader.h>
+
+// b0, b1, b2, a1, a2, normalised so that a0 is 1: the layout of a second order
+// IIR::Coefficients
+using BiquadCoefficients = std::array<float, 5>;
+
+// the second order sections of a Butterworth cut, as many as its Slope needs
+struct CutDesign {
+    std::array<BiquadCoefficients, 4> sections;
+    int numSections{0};
+};
+
+// The same filters as makePeakFilter(), makeLowCutFilter() and makeHighCutFilter(),
+// computed in double precision straight into values. Safe on the audio thread.
+BiquadCoefficients designPeak(const ChainSettings &chainSettings, double sampleRate) noexcept;
+CutDesign designLowCut(const ChainSettings &chainSettings, double sampleRate) noexcept;
+CutDesign designHighCut(const ChainSettings &chainSettings, double sampleRate) noexcept;
+
+// Copies into the filter's own coefficients. Only allocates if they aren't second
+// order yet, which prepareToPlay() rules out by priming every stage of every chain
+// with makePrimingSet().
+void setCoefficients(Filter &filter, const BiquadCoefficients &coefficients);
+void setCutCoefficients(CutFilter &cut, const CutDesign &design);
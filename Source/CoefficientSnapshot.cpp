@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    CoefficientSnapshot.cpp
+    A read-only copy of the coefficients the audio thread is applying.
+
+  ==============================================================================
+*/
+
+#include "CoefficientSnapshot.h"
+
+double CoefficientSnapshot::Stage::getMagnitudeForFrequency(double frequency,
+                                                            double sampleRate) const {
+    // same as juce::dsp::IIR::Coefficients::getMagnitudeForFrequency()
+    if (numCoefficients == 0) return 1.0;
+
+    constexpr std::complex<double> j(0, 1);
+    const auto order = (numCoefficients - 1) / 2;
+
+    std::complex<double> numerator = 0.0, denominator = 1.0, factor = 1.0;
+    std::complex<double> jw =
+        std::exp(-juce::MathConstants<double>::twoPi * frequency * j / sampleRate);
+
+    for (int n = 0; n <= order; ++n) {
+        numerator += static_cast<double>(coefficients[n]) * factor;
+        factor *= jw;
+    }
+
+    factor = jw;
+    for (int n = order + 1; n <= 2 * order; ++n) {
+        denominator += static_cast<double>(coefficients[n]) * factor;
+        factor *= jw;
+    }
+
+    return std::abs(numerator / denominator);
+}
+
+bool CoefficientSnapshot::Stage::operator==(const Stage &other) const {
+    return numCoefficients == other.numCoefficients &&
+           std::equal(coefficients.begin(), coefficients.begin() + numCoefficients,
+                      other.coefficients.begin());
+}
+
+double CoefficientSnapshot::getMagnitudeForFrequency(double frequency) const {
+    if (sampleRate <= 0) return 1.0;
+
+    double mag = 1.0;
+    for (const auto &stage : stages) mag *= stage.getMagnitudeForFrequency(frequency, sampleRate);
+    return mag;
+}
+
+//==============================================================================
+static void fillStage(CoefficientSnapshot::Stage &stage, const Filter &filter, bool bypassed) {
+    const auto &coefficients = filter.coefficients->coefficients;
+    stage.numCoefficients =
+        bypassed ? 0 : juce::jmin(coefficients.size(), int(stage.coefficients.size()));
+    std::copy(coefficients.begin(), coefficients.begin() + stage.numCoefficients,
+              stage.coefficients.begin());
+}
+
+template <typename CutType>
+static void fillCutStages(CoefficientSnapshot::Stage *stages, const CutType &cut) {
+    fillStage(stages[0], cut.template get<0>(), cut.template isBypassed<0>());
+    fillStage(stages[1], cut.template get<1>(), cut.template isBypassed<1>());
+    fillStage(stages[2], cut.template get<2>(), cut.template isBypassed<2>());
+    fillStage(stages[3], cut.template get<3>(), cut.template isBypassed<3>());
+}
+
+void CoefficientSnapshotBuffer::publish(const MonoChain &chain, double sampleRate) noexcept {
+    auto &snapshot = buffers[writeIndex];
+
+    fillCutStages(&snapshot.stages[0], chain.get<ChainPositions::LowCut>());
+    fillStage(snapshot.stages[4], chain.get<ChainPositions::Peak>(),
+              chain.isBypassed<ChainPositions::Peak>());
+    fillCutStages(&snapshot.stages[5], chain.get<ChainPositions::HighCut>());
+    snapshot.sampleRate = sampleRate;
+
+    if (snapshot.sampleRate == lastPublished.sampleRate &&
+        snapshot.stages == lastPublished.stages)
+        return;
+
+    snapshot.version = lastPublished.version + 1;
+    lastPublished = snapshot;
+
+    writeIndex = middle.exchange(writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+}
+
+bool CoefficientSnapshotBuffer::read(CoefficientSnapshot &destination) noexcept {
+    if ((middle.load(std::memory_order_acquire) & freshFlag) != 0)
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+    // the reader's slot keeps the latest snapshot, so a new reader gets it too
+    const auto &latest = buffers[readIndex];
+    if (latest.version == destination.version) return false;
+
+    destination = latest;
+    return true;
+}
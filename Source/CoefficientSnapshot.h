@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    CoefficientSnapshot.h
+    A read-only copy of the coefficients the audio thread is applying.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FilterChain.h"
+#include <JuceHeader.h>
+
+struct CoefficientSnapshot {
+    struct Stage {
+        // b0, b1, b2, a1, a2 for a second order section; nothing if the stage is bypassed
+        std::array<float, 5> coefficients{};
+        int numCoefficients{0};
+
+        double getMagnitudeForFrequency(double frequency, double sampleRate) const;
+        bool operator==(const Stage &other) const;
+    };
+
+    // low cut stages, the peak, then the high cut stages
+    std::array<Stage, 9> stages;
+    double sampleRate{0};
+    juce::uint32 version{0};
+
+    // the magnitude of the whole chain
+    double getMagnitudeForFrequency(double frequency) const;
+};
+
+// Hands snapshots from the audio thread to the message thread through a
+// lock-free triple buffer. There must only be one writer and one reader.
+class CoefficientSnapshotBuffer {
+  public:
+    // Writer side. Copies the chain's coefficients and publishes them under a new
+    // version, unless they are the same as the last ones published.
+    void publish(const MonoChain &chain, double sampleRate) noexcept;
+
+    // Reader side. Copies the latest snapshot into destination and returns true,
+    // or returns false if destination already has that version.
+    bool read(CoefficientSnapshot &destination) noexcept;
+
+  private:
+    std::array<CoefficientSnapshot, 3> buffers;
+    static constexpr int indexMask = 3, freshFlag = 4;
+
+    // the writer's, the shared and the reader's index each on a line of their own
+    alignas(cacheLineSize) int writeIndex{0};
+    CoefficientSnapshot lastPublished; // writer only
+    alignas(cacheLineSize) std::atomic<int> middle{1};
+    alignas(cacheLineSize) int readIndex{2};
+};
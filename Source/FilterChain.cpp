@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    FilterChain.cpp
+    The filter chain shared by the processor, the editor and the program bank.
+
+  ==============================================================================
+*/
+
+#include "FilterChain.h"
+
+void updateCoefficients(Coefficients &old, const Coefficients &replacements) {
+    // copy in place when the sizes match, assigning the arrays would reallocate
+    auto &dst = old->coefficients;
+    const auto &src = replacements->coefficients;
+    if (dst.size() == src.size())
+        std::copy(src.begin(), src.end(), dst.begin());
+    else
+        *old = *replacements;
+}
+
+void encodeMidSide(float *left, float *right, int numSamples) noexcept {
+    using FVO = juce::FloatVectorOperations;
+    FVO::add(left, right, numSamples);           // l + r
+    FVO::multiply(left, 0.5f, numSamples);       // mid = (l + r) / 2
+    FVO::subtract(right, left, right, numSamples); // side = mid - r = (l - r) / 2
+}
+
+void decodeMidSide(float *mid, float *side, int numSamples) noexcept {
+    using FVO = juce::FloatVectorOperations;
+    FVO::add(mid, side, numSamples);        // l = mid + side
+    FVO::multiply(side, -2.f, numSamples);  // -2 side
+    FVO::add(side, mid, numSamples);        // r = l - 2 side = mid - side
+}
+
+double getButterworthQuality(int order, int section) noexcept {
+    using namespace juce;
+    return 1.0 /
+           (2.0 * std::cos((2.0 * section + 1.0) * MathConstants<double>::pi / (order * 2.0)));
+}
+
+Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate) {
+    // it's on the heap
+    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
+        sampleRate, chainSettings.peakFreq, chainSettings.peakQuality,
+        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+}
+
+CoefficientSet makeCoefficientSet(const ChainSettings &chainSettings, double sampleRate) {
+    CoefficientSet set;
+    set.settings = chainSettings;
+    set.sampleRate = sampleRate;
+    set.peak = makePeakFilter(chainSettings, sampleRate);
+    set.lowCut = makeLowCutFilter(chainSettings, sampleRate);
+    set.highCut = makeHighCutFilter(chainSettings, sampleRate);
+    return set;
+}
+
+CoefficientSet makePrimingSet(const ChainSettings &chainSettings, double sampleRate) {
+    auto steepest = chainSettings;
+    steepest.lowCutSlope = steepest.highCutSlope = Slope48;
+    return makeCoefficientSet(steepest, sampleRate);
+}
+
+void applyCoefficientSet(MonoChain &chain, const CoefficientSet &coefficientSet) {
+    updateCoefficients(chain.get<ChainPositions::Peak>().coefficients, coefficientSet.peak);
+    updateCutFilter(chain.get<ChainPositions::LowCut>(), coefficientSet.lowCut,
+                    coefficientSet.settings.lowCutSlope);
+    updateCutFilter(chain.get<ChainPositions::HighCut>(), coefficientSet.highCut,
+                    coefficientSet.settings.highCutSlope);
+}
+
+template <typename CutType>
+static void copyCutCoefficients(CutType &destination, const CutType &source) {
+    updateCoefficients(destination.template get<0>().coefficients,
+                       source.template get<0>().coefficients);
+    updateCoefficients(destination.template get<1>().coefficients,
+                       source.template get<1>().coefficients);
+    updateCoefficients(destination.template get<2>().coefficients,
+                       source.template get<2>().coefficients);
+    updateCoefficients(destination.template get<3>().coefficients,
+                       source.template get<3>().coefficients);
+    destination.template setBypassed<0>(source.template isBypassed<0>());
+    destination.template setBypassed<1>(source.template isBypassed<1>());
+    destination.template setBypassed<2>(source.template isBypassed<2>());
+    destination.template setBypassed<3>(source.template isBypassed<3>());
+}
+
+void copyCoefficients(MonoChain &destination, const MonoChain &source) {
+    copyCutCoefficients(destination.get<ChainPositions::LowCut>(),
+                        source.get<ChainPositions::LowCut>());
+    updateCoefficients(destination.get<ChainPositions::Peak>().coefficients,
+                       source.get<ChainPositions::Peak>().coefficients);
+    copyCutCoefficients(destination.get<ChainPositions::HighCut>(),
+                        source.get<ChainPositions::HighCut>());
+}
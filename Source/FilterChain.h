@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    FilterChain.h
+    The filter chain shared by the processor, the editor and the program bank.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// For keeping state written by different threads apart. Build with
+// SIMPLEEQ_SEPARATE_CACHE_LINES=0 for the packed layout, to compare the two in the
+// load test.
+#ifndef SIMPLEEQ_SEPARATE_CACHE_LINES
+#define SIMPLEEQ_SEPARATE_CACHE_LINES 1
+#endif
+constexpr size_t cacheLineSize = SIMPLEEQ_SEPARATE_CACHE_LINES ? 64 : alignof(std::max_align_t);
+
+enum Slope { Slope12, Slope24, Slope36, Slope48 };
+
+struct ChainSettings {
+    float peakFreq{0}, peakGainInDecibels{0}, peakQuality{1.f};
+    float lowCutFreq{0}, highCutFreq{0};
+    Slope lowCutSlope{Slope::Slope12}, highCutSlope{Slope::Slope12};
+};
+
+using Filter = juce::dsp::IIR::Filter<float>;
+
+using CutFilter =
+    juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>; // 4 filters for different slopes
+
+using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
+
+enum ChainPositions { LowCut, Peak, HighCut };
+
+// What the two chains of a stereo signal run on: left and right with the same
+// settings, mid and side with their own settings, or only one of mid and side.
+enum class StereoMode { Stereo, MidSide, MidOnly, SideOnly };
+
+// How the chain's stages are implemented: the direct form biquads of MonoChain, or
+// the state variable filters of SvfChain, whose coefficients can change every sample.
+enum class FilterTopology { Biquad, Svf };
+
+// In place, left becomes mid and right becomes side, and back.
+void encodeMidSide(float *left, float *right, int numSamples) noexcept;
+void decodeMidSide(float *mid, float *side, int numSamples) noexcept;
+
+using Coefficients = Filter::CoefficientsPtr;
+void updateCoefficients(Coefficients &old, const Coefficients &replacements);
+
+Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
+
+template <int Index, typename ChainType, typename CoefficientType>
+void update(ChainType &chain, const CoefficientType &coefficients) {
+    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
+    chain.template setBypassed<Index>(false);
+}
+template <typename ChainType, typename CoefficientType>
+void updateCutFilter(ChainType &cut, const CoefficientType &cutCoefficients, const Slope &slope) {
+    cut.template setBypassed<0>(true);
+    cut.template setBypassed<1>(true);
+    cut.template setBypassed<2>(true);
+    cut.template setBypassed<3>(true);
+    switch (slope) {
+    case Slope48:
+        update<3>(cut, cutCoefficients);
+    case Slope36:
+        update<2>(cut, cutCoefficients);
+    case Slope24:
+        update<1>(cut, cutCoefficients);
+    case Slope12:
+        update<0>(cut, cutCoefficients);
+        break;
+    }
+}
+
+// The quality of each second order section of a Butterworth filter of the given
+// order, in the order FilterDesign's Butterworth methods design them. For the
+// designers and the SVFs, which build the same cuts without FilterDesign.
+double getButterworthQuality(int order, int section) noexcept;
+
+inline auto makeLowCutFilter(const ChainSettings &chainSettings, double sampleRate) {
+    // 0: 12db/oct -> order: 2
+    // 1: 18db/oct -> order: 4 ...
+    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
+        chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
+}
+
+inline auto makeHighCutFilter(const ChainSettings &chainSettings, double sampleRate) {
+    // 0: 12db/oct -> order: 2
+    // 1: 18db/oct -> order: 4 ...
+    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
+        chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1));
+}
+
+// One sample through the chain, for samples that aren't contiguous in memory.
+inline float processSample(CutFilter &cut, float sample) noexcept {
+    if (!cut.isBypassed<0>()) sample = cut.get<0>().processSample(sample);
+    if (!cut.isBypassed<1>()) sample = cut.get<1>().processSample(sample);
+    if (!cut.isBypassed<2>()) sample = cut.get<2>().processSample(sample);
+    if (!cut.isBypassed<3>()) sample = cut.get<3>().processSample(sample);
+    return sample;
+}
+
+inline float processSample(MonoChain &chain, float sample) noexcept {
+    if (!chain.isBypassed<ChainPositions::LowCut>())
+        sample = processSample(chain.get<ChainPositions::LowCut>(), sample);
+    if (!chain.isBypassed<ChainPositions::Peak>())
+        sample = chain.get<ChainPositions::Peak>().processSample(sample);
+    if (!chain.isBypassed<ChainPositions::HighCut>())
+        sample = processSample(chain.get<ChainPositions::HighCut>(), sample);
+    return sample;
+}
+
+// All the coefficients of a chain, designed ahead of time so that they can be
+// handed to the audio thread without any design work or allocation there.
+struct CoefficientSet {
+    ChainSettings settings;
+    double sampleRate{0};
+
+    Coefficients peak;
+    juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> lowCut, highCut;
+};
+
+CoefficientSet makeCoefficientSet(const ChainSettings &chainSettings, double sampleRate);
+void applyCoefficientSet(MonoChain &chain, const CoefficientSet &coefficientSet);
+
+// The settings with the steepest cuts, whose set gives every stage of a chain its
+// second order coefficients, so that later updates only copy values into them.
+// Allocates, for when the chains are prepared.
+CoefficientSet makePrimingSet(const ChainSettings &chainSettings, double sampleRate);
+
+// copies the coefficients and bypass states of every stage, but not the filter state
+void copyCoefficients(MonoChain &destination, const MonoChain &source);
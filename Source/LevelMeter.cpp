@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    LevelMeter.cpp
+    Peak, RMS and true peak levels measured on the audio thread, read lock-free
+    by the editor.
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+// the reader resets to 0 in between, so a plain max-store could bring an old value back
+static void storeMax(std::atomic<float> &level, float value) noexcept {
+    auto current = level.load(std::memory_order_relaxed);
+    while (value > current &&
+           !level.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LevelMeter::prepare(double sampleRate) {
+    rmsDecayPerSample = (float)std::exp(-1.0 / (0.3 * sampleRate));
+    states = {};
+}
+
+// Independent running sums and maxima, one per lane, which the compiler keeps in
+// four vector registers: one float accumulator can't be vectorised without
+// reordering its additions, which it won't do without fast-math, and four hide the
+// latency of each add.
+static constexpr int numLanes = 16;
+
+static float getSumOfSquares(const float *samples, int numSamples) noexcept {
+    float lanes[numLanes]{};
+    int i = 0;
+    for (; i + numLanes <= numSamples; i += numLanes)
+        for (int lane = 0; lane < numLanes; ++lane)
+            lanes[lane] += samples[i + lane] * samples[i + lane];
+
+    float sum = 0;
+    for (; i < numSamples; ++i) sum += samples[i] * samples[i];
+    for (auto lane : lanes) sum += lane;
+    return sum;
+}
+
+// halfway between x[i + 1] and x[i + 2] by cubic interpolation, which is 2x
+// oversampling and catches most of the overs that sample peaks miss
+static float getBetween(const float *x, int i) noexcept {
+    return std::abs((9.f * (x[i + 1] + x[i + 2]) - (x[i] + x[i + 3])) * (1.f / 16.f));
+}
+
+// the highest of those over x[0 .. numPoints + 2]
+static float getTruePeak(const float *x, int numPoints) noexcept {
+    float lanes[numLanes]{};
+    int i = 0;
+    for (; i + numLanes <= numPoints; i += numLanes)
+        for (int lane = 0; lane < numLanes; ++lane)
+            lanes[lane] = juce::jmax(lanes[lane], getBetween(x, i + lane));
+
+    float peak = 0;
+    for (; i < numPoints; ++i) peak = juce::jmax(peak, getBetween(x, i));
+    for (auto lane : lanes) peak = juce::jmax(peak, lane);
+    return peak;
+}
+
+void LevelMeter::measure(const float *const *channels, int numChannels,
+                         int numSamples) noexcept {
+    if (numSamples <= 0) return;
+
+    numChannels = juce::jmin(numChannels, maxChannels);
+    numMeasuredChannels.store(numChannels, std::memory_order_relaxed);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto *samples = channels[channel];
+        auto &state = states[(size_t)channel];
+
+        auto range = juce::FloatVectorOperations::findMinAndMax(samples, numSamples);
+        auto peak = juce::jmax(-range.getStart(), range.getEnd());
+        auto sumOfSquares = getSumOfSquares(samples, numSamples);
+
+        // the points between the last block's three samples and this block's first
+        // three, then those within the block
+        float edge[6] = {state.x0, state.x1, state.x2};
+        for (int i = 0; i < juce::jmin(numSamples, 3); ++i) edge[3 + i] = samples[i];
+        auto truePeak = getTruePeak(edge, juce::jmin(numSamples, 3));
+        if (numSamples > 3)
+            truePeak = juce::jmax(truePeak, getTruePeak(samples, numSamples - 3));
+
+        auto *last = numSamples > 3 ? samples + numSamples - 3 : edge + numSamples;
+        state.x0 = last[0];
+        state.x1 = last[1];
+        state.x2 = last[2];
+
+        // one step of the exponential average for the whole block
+        auto decay = std::pow(rmsDecayPerSample, (float)numSamples);
+        state.meanSquare = decay * state.meanSquare + (1.f - decay) * sumOfSquares / numSamples;
+
+        auto &levels = published[(size_t)channel];
+        storeMax(levels.peak, peak);
+        storeMax(levels.truePeak, juce::jmax(peak, truePeak));
+        levels.rms.store(std::sqrt(state.meanSquare), std::memory_order_relaxed);
+    }
+}
+
+ChannelLevels LevelMeter::read(int channel) noexcept {
+    jassert(juce::isPositiveAndBelow(channel, maxChannels));
+    auto &levels = published[(size_t)channel];
+
+    ChannelLevels result;
+    result.peak = levels.peak.exchange(0.f, std::memory_order_relaxed);
+    result.truePeak = levels.truePeak.exchange(0.f, std::memory_order_relaxed);
+    result.rms = levels.rms.load(std::memory_order_relaxed);
+    return result;
+}
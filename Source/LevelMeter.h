@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Peak, RMS and true peak levels measured on the audio thread, read lock-free
+    by the editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FilterChain.h"
+#include <JuceHeader.h>
+
+// linear amplitudes
+struct ChannelLevels {
+    float peak{0}, rms{0}, truePeak{0};
+};
+
+class LevelMeter {
+  public:
+    // as wide as any main bus the processor accepts
+    static constexpr int maxChannels = 128;
+
+    void prepare(double sampleRate);
+
+    // Audio thread. One pass over each channel for all three levels.
+    void measure(const float *const *channels, int numChannels, int numSamples) noexcept;
+
+    // Any other thread. The peaks are the highest since the last read, the RMS is
+    // over the last 300 ms.
+    ChannelLevels read(int channel) noexcept;
+
+    // Any other thread. How many channels the last block had.
+    int getNumChannels() const noexcept {
+        return numMeasuredChannels.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // what only the audio thread touches
+    struct ChannelState {
+        float meanSquare{0};
+        // the last three samples, for the inter-sample peaks across blocks
+        float x0{0}, x1{0}, x2{0};
+    };
+    std::array<ChannelState, maxChannels> states;
+    float rmsDecayPerSample{0};
+
+    struct PublishedLevels {
+        std::atomic<float> peak{0}, rms{0}, truePeak{0};
+    };
+    alignas(cacheLineSize) std::array<PublishedLevels, maxChannels> published;
+    std::atomic<int> numMeasuredChannels{0};
+};
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    ParallelChannelRenderer.cpp
+    Persistent worker threads that process a block's channels in parallel.
+
+  ==============================================================================
+*/
+
+#include "ParallelChannelRenderer.h"
+#include "TraceProfiler.h"
+
+void ParallelChannelRenderer::start(int numWorkers) {
+    if ((int)workers.size() == numWorkers) return;
+
+    stop();
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::make_unique<Worker>(*this));
+        workers.back()->startThread();
+    }
+}
+
+void ParallelChannelRenderer::stop() {
+    for (auto &worker : workers) {
+        worker->signalThreadShouldExit();
+        worker->startEvent.signal();
+    }
+    for (auto &worker : workers) worker->stopThread(1000);
+    workers.clear();
+}
+
+void ParallelChannelRenderer::runChannels(int channels, ChannelFunction channelFunction,
+                                          void *functionContext) {
+    function = channelFunction;
+    context = functionContext;
+    numChannels = channels;
+    nextChannel = 0;
+
+    // Every worker goes through work() once per run, even if there's nothing left
+    // by the time it wakes up, so none of them can still be claiming channels
+    // when the next run resets the counter.
+    busyWorkers = (int)workers.size();
+    allWorkersDone.reset();
+    for (auto &worker : workers) worker->startEvent.signal();
+
+    work();
+
+    if (!workers.empty()) allWorkersDone.wait(-1);
+}
+
+void ParallelChannelRenderer::work() noexcept {
+    // the same denormal handling as the audio thread, or the results could differ
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto channel = nextChannel.fetch_add(1); channel < numChannels;
+         channel = nextChannel.fetch_add(1))
+        function(context, channel);
+}
+
+void ParallelChannelRenderer::Worker::run() {
+    SIMPLEEQ_TRACE_REGISTER_THREAD("SimpleEQ Renderer");
+
+    while (!threadShouldExit()) {
+        startEvent.wait(-1);
+        if (threadShouldExit()) break;
+
+        {
+            SIMPLEEQ_TRACE_SCOPE("ParallelChannelRenderer::work");
+            owner.work();
+        }
+        if (owner.busyWorkers.fetch_sub(1) == 1) owner.allWorkersDone.signal();
+    }
+    // workers come and go with start() and stop(), their buffers go to the next ones
+    SIMPLEEQ_TRACE_RELEASE_THREAD();
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    ParallelChannelRenderer.h
+    Persistent worker threads that process a block's channels in parallel.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// The calling thread and the workers claim channels one at a time from a shared
+// counter until none are left, so whoever is free takes the next channel and a
+// slow channel doesn't hold up the rest. Each channel is processed by exactly one
+// thread, so as long as channels are independent the result is the same as
+// processing them one after another.
+//
+// For offline rendering only: run() blocks until every worker is done.
+class ParallelChannelRenderer {
+  public:
+    ParallelChannelRenderer() = default;
+    ~ParallelChannelRenderer() { stop(); }
+
+    // Keeps the running workers if there are that many already. Not to be called
+    // while run() may be running.
+    void start(int numWorkers);
+    void stop();
+    bool isRunning() const noexcept { return !workers.empty(); }
+
+    // Calls processChannel(channel) for every channel in 0 .. numChannels - 1 and
+    // returns once all of them are done. Doesn't allocate.
+    template <typename Function> void run(int numChannels, Function &processChannel) {
+        runChannels(
+            numChannels,
+            [](void *context, int channel) { (*static_cast<Function *>(context))(channel); },
+            &processChannel);
+    }
+
+  private:
+    using ChannelFunction = void (*)(void *context, int channel);
+
+    struct Worker : juce::Thread {
+        explicit Worker(ParallelChannelRenderer &renderer)
+            : juce::Thread("SimpleEQ Renderer"), owner(renderer) {}
+        void run() override;
+
+        ParallelChannelRenderer &owner;
+        juce::WaitableEvent startEvent; // once per run()
+    };
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // set before the workers are woken, which orders them before the workers' reads
+    ChannelFunction function{nullptr};
+    void *context{nullptr};
+    int numChannels{0};
+
+    std::atomic<int> nextChannel{0};
+    std::atomic<int> busyWorkers{0};
+    juce::WaitableEvent allWorkersDone;
+
+    void runChannels(int channels, ChannelFunction channelFunction, void *functionContext);
+    void work() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(ParallelChannelRenderer)
+};
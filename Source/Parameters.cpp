@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    Parameters.cpp
+    The one table of parameters, and typed realtime access to their values.
+
+  ==============================================================================
+*/
+
+#include "Parameters.h"
+#include "TraceProfiler.h"
+
+// The table as JUCE objects, built once per process and shared by every instance,
+// which only copy (i.e. reference count) the strings.
+struct ParamMetadata {
+    ParamMetadata() {
+        for (size_t i = 0; i < numParams; ++i) {
+            const auto &spec = paramSpecs[i];
+            ids[i] = spec.id;
+            ranges[i] = {spec.start, spec.end, spec.interval, spec.skew};
+            if (spec.choices != nullptr) choices[i] = juce::StringArray(spec.choices, spec.numChoices);
+        }
+    }
+
+    std::array<juce::String, numParams> ids;
+    std::array<juce::NormalisableRange<float>, numParams> ranges;
+    std::array<juce::StringArray, numParams> choices;
+};
+
+static const ParamMetadata &getMetadata() {
+    static const ParamMetadata metadata;
+    return metadata;
+}
+
+Parameters::Parameters(juce::AudioProcessorValueTreeState &state) : apvts(state) {
+    SIMPLEEQ_TRACE_SCOPE("Parameters");
+
+    const auto &ids = getMetadata().ids;
+    for (size_t i = 0; i < numParams; ++i) {
+        values[i] = apvts.getRawParameterValue(ids[i]);
+        jassert(values[i] != nullptr);
+        apvts.addParameterListener(ids[i], &counters[i]);
+    }
+}
+
+Parameters::~Parameters() {
+    const auto &ids = getMetadata().ids;
+    for (size_t i = 0; i < numParams; ++i) apvts.removeParameterListener(ids[i], &counters[i]);
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createLayout() {
+    SIMPLEEQ_TRACE_SCOPE("createParameterLayout");
+
+    const auto &metadata = getMetadata();
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (size_t i = 0; i < numParams; ++i) {
+        const auto &spec = paramSpecs[i];
+        const auto &id = metadata.ids[i];
+        if (spec.choices != nullptr) {
+            layout.add(std::make_unique<juce::AudioParameterChoice>(
+                id, id, metadata.choices[i], juce::roundToInt(spec.defaultValue)));
+        } else {
+            layout.add(std::make_unique<juce::AudioParameterFloat>(id, id, metadata.ranges[i],
+                                                                   spec.defaultValue));
+        }
+    }
+
+    return layout;
+}
+
+ChainSettings Parameters::getChainSettings() const noexcept {
+    ChainSettings settings;
+    settings.lowCutFreq = get<Param::LowCutFreq>();
+    settings.highCutFreq = get<Param::HighCutFreq>();
+    settings.peakFreq = get<Param::PeakFreq>();
+    settings.peakGainInDecibels = get<Param::PeakGain>();
+    settings.peakQuality = get<Param::PeakQuality>();
+    settings.lowCutSlope = static_cast<Slope>(get<Param::LowCutSlope>());
+    settings.highCutSlope = static_cast<Slope>(get<Param::HighCutSlope>());
+    return settings;
+}
+
+ChainSettings Parameters::getSideChainSettings() const noexcept {
+    ChainSettings settings;
+    settings.lowCutFreq = get<Param::SideLowCutFreq>();
+    settings.highCutFreq = get<Param::SideHighCutFreq>();
+    settings.peakFreq = get<Param::SidePeakFreq>();
+    settings.peakGainInDecibels = get<Param::SidePeakGain>();
+    settings.peakQuality = get<Param::SidePeakQuality>();
+    settings.lowCutSlope = static_cast<Slope>(get<Param::SideLowCutSlope>());
+    settings.highCutSlope = static_cast<Slope>(get<Param::SideHighCutSlope>());
+    return settings;
+}
+
+bool Parameters::consumeAllChanges(Generations &seen) const noexcept {
+    bool changed = false;
+    for (size_t i = 0; i < numParams; ++i) changed |= consumeChange(i, seen);
+    return changed;
+}
+
+bool Parameters::consumeChange(size_t index, Generations &seen) const noexcept {
+    auto generation = counters[index].generation.load(std::memory_order_acquire);
+    if (generation == seen[index]) return false;
+
+    seen[index] = generation;
+    return true;
+}
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    Parameters.h
+    The one table of parameters, and typed realtime access to their values.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FilterChain.h"
+#include <JuceHeader.h>
+
+enum class Param {
+    LowCutFreq,
+    HighCutFreq,
+    PeakFreq,
+    PeakGain,
+    PeakQuality,
+    LowCutSlope,
+    HighCutSlope,
+    StereoMode,
+    // the side chain's settings in StereoMode::MidSide
+    SideLowCutFreq,
+    SideHighCutFreq,
+    SidePeakFreq,
+    SidePeakGain,
+    SidePeakQuality,
+    SideLowCutSlope,
+    SideHighCutSlope,
+    FilterTopology,
+    // the peak's gain following the sidechain's (or the input's) level, SVF only
+    PeakDynamicRange,
+    PeakDynamicThreshold,
+    PeakDynamicAttack,
+    PeakDynamicRelease,
+};
+
+struct ParamSpec {
+    const char *id; // also the name shown to the host
+    float start, end, interval, skew, defaultValue;
+    // a choice parameter if not nullptr, with values 0 .. numChoices - 1
+    const char *const *choices{nullptr};
+    int numChoices{0};
+};
+
+constexpr const char *slopeChoices[] = {"12 db/Oct", "24 db/Oct", "36 db/Oct", "48 db/Oct"};
+// in the order of StereoMode
+constexpr const char *stereoModeChoices[] = {"Stereo", "Mid/Side", "Mid Only", "Side Only"};
+// in the order of FilterTopology
+constexpr const char *topologyChoices[] = {"Biquad", "SVF"};
+
+// in the order of Param
+constexpr ParamSpec paramSpecs[] = {
+    {"LowCut Freq", 20.f, 20000.f, 1.f, 0.25f, 20.f},
+    {"HighCut Freq", 20.f, 20000.f, 1.f, 0.25f, 20000.f},
+    {"Peak Freq", 20.f, 20000.f, 1.f, 0.25f, 750.f},
+    {"Peak Gain", -24.f, 24.f, 0.5f, 1.f, 0.f},
+    {"Peak Quality", 0.1f, 10.f, 0.05f, 1.f, 1.f},
+    {"LowCut Slope", 0.f, 3.f, 1.f, 1.f, 0.f, slopeChoices, 4},
+    {"HighCut Slope", 0.f, 3.f, 1.f, 1.f, 0.f, slopeChoices, 4},
+    {"Stereo Mode", 0.f, 3.f, 1.f, 1.f, 0.f, stereoModeChoices, 4},
+    {"Side LowCut Freq", 20.f, 20000.f, 1.f, 0.25f, 20.f},
+    {"Side HighCut Freq", 20.f, 20000.f, 1.f, 0.25f, 20000.f},
+    {"Side Peak Freq", 20.f, 20000.f, 1.f, 0.25f, 750.f},
+    {"Side Peak Gain", -24.f, 24.f, 0.5f, 1.f, 0.f},
+    {"Side Peak Quality", 0.1f, 10.f, 0.05f, 1.f, 1.f},
+    {"Side LowCut Slope", 0.f, 3.f, 1.f, 1.f, 0.f, slopeChoices, 4},
+    {"Side HighCut Slope", 0.f, 3.f, 1.f, 1.f, 0.f, slopeChoices, 4},
+    {"Filter Topology", 0.f, 1.f, 1.f, 1.f, 0.f, topologyChoices, 2},
+    {"Peak Dynamic Range", -24.f, 24.f, 0.5f, 1.f, 0.f},
+    {"Peak Dynamic Threshold", -60.f, 0.f, 0.5f, 1.f, -24.f},
+    {"Peak Dynamic Attack", 0.1f, 100.f, 0.1f, 0.5f, 5.f},
+    {"Peak Dynamic Release", 5.f, 1000.f, 1.f, 0.5f, 100.f},
+};
+
+constexpr size_t numParams = std::size(paramSpecs);
+
+constexpr const ParamSpec &getParamSpec(Param param) { return paramSpecs[size_t(param)]; }
+constexpr const char *getParamID(Param param) { return getParamSpec(param).id; }
+
+//==============================================================================
+// Resolves every parameter's value once, so that the audio thread reads them with
+// plain atomic loads, and counts the changes of each parameter so that it can
+// tell what has changed since it last looked.
+class Parameters {
+  public:
+    explicit Parameters(juce::AudioProcessorValueTreeState &apvts);
+    ~Parameters();
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
+
+    template <Param P> float get() const noexcept {
+        return values[size_t(P)]->load(std::memory_order_relaxed);
+    }
+    ChainSettings getChainSettings() const noexcept;
+    ChainSettings getSideChainSettings() const noexcept;
+    StereoMode getStereoMode() const noexcept {
+        return static_cast<StereoMode>(juce::roundToInt(get<Param::StereoMode>()));
+    }
+    FilterTopology getFilterTopology() const noexcept {
+        return static_cast<FilterTopology>(juce::roundToInt(get<Param::FilterTopology>()));
+    }
+
+    // the generations of all parameters the reader has seen
+    using Generations = std::array<juce::uint32, numParams>;
+
+    // Returns true if any of the parameters has changed since seen, and marks
+    // their current generations as seen.
+    template <Param... Ps> bool consumeChanges(Generations &seen) const noexcept {
+        bool changed = false;
+        ((changed |= consumeChange(size_t(Ps), seen)), ...);
+        return changed;
+    }
+    bool consumeAllChanges(Generations &seen) const noexcept;
+
+  private:
+    juce::AudioProcessorValueTreeState &apvts;
+    std::array<std::atomic<float> *, numParams> values;
+
+    // bumped by the APVTS after it has stored the new value
+    struct GenerationCounter : juce::AudioProcessorValueTreeState::Listener {
+        void parameterChanged(const juce::String &, float) override {
+            generation.fetch_add(1, std::memory_order_release);
+        }
+        std::atomic<juce::uint32> generation{0};
+    };
+    std::array<GenerationCounter, numParams> counters;
+
+    bool consumeChange(size_t index, Generations &seen) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(Parameters)
+};
@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+
+    PathVerifier.cpp
+    Opt-in check of the processor's output against the reference chain.
+
+  ==============================================================================
+*/
+
+#include "PathVerifier.h"
+
+#if SIMPLEEQ_VERIFY_FAST_PATHS
+
+static bool isSameSettings(const ChainSettings &a, const ChainSettings &b) {
+    return a.peakFreq == b.peakFreq && a.peakGainInDecibels == b.peakGainInDecibels &&
+           a.peakQuality == b.peakQuality && a.lowCutFreq == b.lowCutFreq &&
+           a.highCutFreq == b.highCutFreq && a.lowCutSlope == b.lowCutSlope &&
+           a.highCutSlope == b.highCutSlope;
+}
+
+static bool isSameSlopes(const ChainSettings &a, const ChainSettings &b) {
+    return a.lowCutSlope == b.lowCutSlope && a.highCutSlope == b.highCutSlope;
+}
+
+void PathVerifier::prepare(double newSampleRate, int maximumBlockSize) {
+    // hosts prepare again and again, only the spectrum's bins are for one rate
+    if (newSampleRate != sampleRate) {
+        stats.errorPower = {};
+        stats.numFrames = 0;
+    }
+    sampleRate = newSampleRate;
+    samplesPerWindow = juce::roundToInt(sampleRate);
+
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = (juce::uint32)maximumBlockSize;
+    spec.numChannels = 1;
+    spec.sampleRate = sampleRate;
+    for (auto &chain : reference) chain.prepare(spec);
+
+    input.setSize(2, maximumBlockSize);
+    frame.assign((size_t)fftSize * 2, 0.f);
+    designed = false;
+
+    reset();
+}
+
+void PathVerifier::reset() {
+    for (auto &chain : reference) chain.reset();
+    settlingSamples = 0;
+    windowSumOfSquares = 0;
+    windowSamples = 0;
+    frameSamples = 0;
+}
+
+void PathVerifier::capture(const juce::AudioBuffer<float> &buffer) {
+    capturedSamples = buffer.getNumSamples();
+    // past the promised block size, that block just isn't checked
+    if (capturedSamples > input.getNumSamples() || buffer.getNumChannels() < 2) {
+        capturedSamples = 0;
+        return;
+    }
+
+    for (int channel = 0; channel < 2; ++channel)
+        input.copyFrom(channel, 0, buffer, channel, 0, capturedSamples);
+}
+
+void PathVerifier::check(const juce::AudioBuffer<float> &output,
+                         const ChainSettings &chainSettings, const ChainSettings &sideSettings,
+                         StereoMode stereoMode, const Tolerances *tolerances) {
+    if (publishPending) publish();
+
+    auto numSamples = capturedSamples;
+    if (numSamples == 0 || numSamples != output.getNumSamples()) return;
+
+    // the reference as the processor was before any of its faster paths
+    auto &rightSettings = stereoMode == StereoMode::MidSide ? sideSettings : chainSettings;
+    if (!designed) {
+        // primed as the processor primes its chains, the cut stages a slope change
+        // switches on then start from the same state in both
+        auto primingSet = makePrimingSet(chainSettings, sampleRate);
+        for (auto &chain : reference) {
+            applyCoefficientSet(chain, primingSet);
+            chain.reset();
+        }
+    } else if (!isSameSlopes(referenceSettings[0], chainSettings) ||
+               !isSameSlopes(referenceSettings[1], rightSettings)) {
+        settlingSamples = juce::roundToInt(settleSeconds * sampleRate);
+    }
+    if (!designed || !isSameSettings(referenceSettings[0], chainSettings))
+        applyCoefficientSet(reference[0], makeCoefficientSet(chainSettings, sampleRate));
+    if (!designed || !isSameSettings(referenceSettings[1], rightSettings))
+        applyCoefficientSet(reference[1], makeCoefficientSet(rightSettings, sampleRate));
+    referenceSettings = {chainSettings, rightSettings};
+    designed = true;
+
+    auto *left = input.getWritePointer(0);
+    auto *right = input.getWritePointer(1);
+    auto block = juce::dsp::AudioBlock<float>(input).getSubBlock(0, (size_t)numSamples);
+    auto leftBlock = block.getSingleChannelBlock(0);
+    auto rightBlock = block.getSingleChannelBlock(1);
+    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+    auto midSide = stereoMode != StereoMode::Stereo;
+    if (midSide) encodeMidSide(left, right, numSamples);
+    if (stereoMode != StereoMode::SideOnly) reference[0].process(leftContext);
+    if (stereoMode != StereoMode::MidOnly) reference[1].process(rightContext);
+    if (midSide) decodeMidSide(left, right, numSamples);
+
+    auto settling = settlingSamples > 0;
+    settlingSamples -= juce::jmin(settlingSamples, numSamples);
+    if (tolerances == nullptr || settling) return;
+
+    // the input's copy becomes the error
+    double sumOfSquares = 0;
+    for (int channel = 0; channel < 2; ++channel) {
+        auto *processed = output.getReadPointer(channel);
+        auto *error = input.getWritePointer(channel);
+        for (int i = 0; i < numSamples; ++i) {
+            error[i] = processed[i] - error[i];
+            stats.maxAbsoluteError = juce::jmax(stats.maxAbsoluteError, std::abs(error[i]));
+            sumOfSquares += (double)error[i] * error[i];
+        }
+    }
+    if (stats.maxAbsoluteError > tolerances->maxAbsoluteError) fail();
+
+    windowTolerances = tolerances;
+    addToWindow(sumOfSquares / 2, numSamples);
+    addToSpectrum(input.getReadPointer(0), numSamples);
+}
+
+void PathVerifier::fail() {
+    // see getReport() for what has gone wrong
+    if (!stats.failed) jassertfalse;
+    stats.failed = true;
+    publish();
+}
+
+void PathVerifier::publish() {
+    // never waiting for the reader
+    const juce::SpinLock::ScopedTryLockType lock(publishLock);
+    publishPending = !lock.isLocked();
+    if (lock.isLocked()) published = stats;
+}
+
+void PathVerifier::addToWindow(double sumOfSquares, int numSamples) {
+    windowSumOfSquares += sumOfSquares;
+    windowSamples += numSamples;
+    if (windowSamples >= samplesPerWindow) closeWindow();
+}
+
+void PathVerifier::closeWindow() {
+    auto rms = (float)std::sqrt(windowSumOfSquares / windowSamples);
+    if (stats.firstWindowRms < 0) stats.firstWindowRms = rms;
+    stats.lastWindowRms = rms;
+    stats.maxWindowRms = juce::jmax(stats.maxWindowRms, rms);
+    ++stats.numWindows;
+    if (rms > windowTolerances->maxWindowRmsError) fail();
+
+    windowSumOfSquares = 0;
+    windowSamples = 0;
+    publish();
+}
+
+void PathVerifier::addToSpectrum(const float *error, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        frame[(size_t)frameSamples++] = error[i];
+        if (frameSamples < fftSize) continue;
+
+        window.multiplyWithWindowingTable(frame.data(), (size_t)fftSize);
+        fft.performFrequencyOnlyForwardTransform(frame.data());
+        for (int bin = 0; bin < numBins; ++bin)
+            stats.errorPower[(size_t)bin] += (double)frame[(size_t)bin] * frame[(size_t)bin];
+        ++stats.numFrames;
+
+        std::fill(frame.begin(), frame.end(), 0.f);
+        frameSamples = 0;
+    }
+}
+
+void PathVerifier::finish() {
+    if (windowSamples > 0 && windowTolerances != nullptr) closeWindow();
+
+    const juce::SpinLock::ScopedLockType lock(publishLock);
+    published = stats;
+    publishPending = false;
+}
+
+bool PathVerifier::hasFailed() {
+    const juce::SpinLock::ScopedLockType lock(publishLock);
+    return published.failed;
+}
+
+juce::String PathVerifier::getReport() {
+    Stats report;
+    {
+        const juce::SpinLock::ScopedLockType lock(publishLock);
+        report = published;
+    }
+
+    juce::String text;
+    text << (report.failed ? "FAILED" : "passed") << "\n";
+    text << "max absolute error: " << report.maxAbsoluteError << "\n";
+    text << "error RMS per second over " << report.numWindows
+         << " seconds: first " << report.firstWindowRms << ", last " << report.lastWindowRms
+         << ", max " << report.maxWindowRms << "\n";
+
+    if (report.numFrames == 0) return text;
+
+    // the error's spectrum in octaves, relative to a full scale sine
+    text << "error spectrum (dB):\n";
+    auto binWidth = sampleRate / fftSize;
+    auto fullScale = juce::square(fftSize / 4.0) * report.numFrames; // a Hann windowed sine
+    for (double low = 20.0; low < sampleRate / 2; low *= 2) {
+        auto high = juce::jmin(low * 2, sampleRate / 2);
+        double power = 0;
+        for (auto bin = (int)std::ceil(low / binWidth); bin < numBins && bin * binWidth < high;
+             ++bin)
+            power += report.errorPower[(size_t)bin];
+
+        text << "  " << juce::roundToInt(low) << " - " << juce::roundToInt(high) << " Hz: "
+             << juce::String(juce::Decibels::gainToDecibels(std::sqrt(power / fullScale), -200.0),
+                             1)
+             << "\n";
+    }
+    return text;
+}
+
+bool PathVerifier::writeTo(const juce::File &file) { return file.replaceWithText(getReport()); }
+
+juce::File PathVerifier::getDefaultFile() {
+    return juce::File::getSpecialLocation(juce::File::tempDirectory)
+        .getChildFile("SimpleEQ-verify.txt");
+}
+
+#endif
@@ -7,66 +7,54 @@
 */
 
 #include "PluginEditor.h"
+#include "TraceProfiler.h"
 
 //==============================================================================
-void MyLookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, int width, int height,
-                                     float sliderPosProportional, float rotaryStartAngle,
-                                     float rotaryEndAngle, juce::Slider &slider) {
+void RotarySliderWithLabels::drawKnob(juce::Graphics &g, juce::Rectangle<float> bounds,
+                                      float angle) {
     using namespace juce;
 
-    auto bounds = Rectangle<float>(x, y, width, height);
     g.setColour(Colour(97u, 18u, 167u)); // choose a colour you like
     g.fillEllipse(bounds);
 
     g.setColour(Colour(255u, 154u, 1u)); // choose a colour you like
     g.drawEllipse(bounds, 1.f);
 
-    if (auto *rswl = dynamic_cast<RotarySliderWithLabels *>(&slider)) {
-        auto center = bounds.getCentre();
+    auto center = bounds.getCentre();
 
-        Path p;
+    Path p;
 
-        // draw the pointing bar
-        Rectangle<float> r;
-        r.setLeft(center.getX() - 2);
-        r.setRight(center.getX() + 2);
-        r.setTop(bounds.getY());
-        r.setBottom(center.getY() - rswl->getTextHeight() * 1.5);
-        p.addRoundedRectangle(r, 2.f);
+    // draw the pointing bar
+    Rectangle<float> r;
+    r.setLeft(center.getX() - 2);
+    r.setRight(center.getX() + 2);
+    r.setTop(bounds.getY());
+    r.setBottom(center.getY() - getTextHeight() * 1.5);
+    p.addRoundedRectangle(r, 2.f);
 
-        jassert(rotaryStartAngle < rotaryEndAngle);
-        auto sliderAngRad = jmap(sliderPosProportional, 0.f, 1.f, rotaryStartAngle, rotaryEndAngle);
-        p.applyTransform(AffineTransform().rotated(sliderAngRad, center.getX(), center.getY()));
+    p.applyTransform(AffineTransform().rotated(angle, center.getX(), center.getY()));
 
-        g.fillPath(p);
-
-        // show text at the center
-        g.setFont(rswl->getTextHeight());
-        auto text = rswl->getDisplayString();
-        auto strWidth = g.getCurrentFont().getStringWidth(text);
-
-        r.setSize(strWidth + 4,
-                  rswl->getTextHeight() + 2); // a little bit bigger than the bounding box of text
-        r.setCentre(center);
+    g.fillPath(p);
+}
 
-        g.setColour(Colours::black);
-        g.fillRect(r);
+// The knob is a frame of a filmstrip, whose frames are whole physical pixels. The
+// frames are laid out in a square grid to keep the image within texture limits,
+// and knobs too big for a filmstrip of sensible memory are drawn as they are.
+static constexpr int framesPerRow = 8, numFrames = framesPerRow * framesPerRow;
+static constexpr int maxFrameSize = 128; // a 1024 x 1024 filmstrip, 4 MB
 
-        g.setColour(Colours::white);
-        g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
-    }
-}
+// 7'o clock to 5'o clock
+static const float startAng = juce::degreesToRadians(180.f + 45.f);
+static const float endAng =
+    juce::degreesToRadians(180.f - 45.f) + juce::MathConstants<float>::twoPi;
 
-//==============================================================================
 void RotarySliderWithLabels::paint(juce::Graphics &g) {
     using namespace juce;
-    // 7'o clock to 5'o clock
-    auto startAng = degreesToRadians(180.f + 45.f);
-    auto endAng = degreesToRadians(180.f - 45.f) + MathConstants<float>::twoPi;
 
     auto range = getRange();
 
     auto sliderBounds = getSliderBounds();
+    if (sliderBounds.isEmpty()) return;
 
     // boarders for debug
     //    g.setColour(Colours::red);
@@ -74,36 +62,105 @@ void RotarySliderWithLabels::paint(juce::Graphics &g) {
     //    g.setColour(Colours::yellow);
     //    g.drawRect(sliderBounds);
 
-    getLookAndFeel().drawRotarySlider(g, sliderBounds.getX(), sliderBounds.getY(),
-                                      sliderBounds.getWidth(), sliderBounds.getHeight(),
-                                      jmap(getValue(), range.getStart(), range.getEnd(), 0.0, 1.0),
-                                      startAng, endAng, *this);
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != imagesScale) updateImages(scale);
 
     // display labels
-    auto center = sliderBounds.toFloat().getCentre();
-    auto radius = sliderBounds.getWidth() * 0.5f;
+    g.drawImage(labelsImage, getLocalBounds().toFloat());
+
+    auto proportion = jmap(getValue(), range.getStart(), range.getEnd(), 0.0, 1.0);
+    if (filmstrip.isNull()) {
+        auto ang = jmap(float(proportion), 0.f, 1.f, startAng, endAng);
+        drawKnob(g, sliderBounds.toFloat(), ang);
+    } else {
+        auto size = sliderBounds.getWidth();
+        auto frame = jlimit(0, numFrames - 1, roundToInt(proportion * (numFrames - 1)));
+        g.drawImage(filmstrip, sliderBounds.getX(), sliderBounds.getY(), size, size,
+                    (frame % framesPerRow) * frameSize, (frame / framesPerRow) * frameSize,
+                    frameSize, frameSize);
+    }
 
-    g.setColour(Colour(0u, 172u, 1u));
+    // show text at the center
     g.setFont(getTextHeight());
+    if (getValue() != displayedValue) {
+        displayedValue = getValue();
+        displayString = getDisplayString();
+        displayStringWidth = g.getCurrentFont().getStringWidth(displayString);
+    }
+
+    Rectangle<float> r;
+    r.setSize(displayStringWidth + 4,
+              getTextHeight() + 2); // a little bit bigger than the bounding box of text
+    r.setCentre(sliderBounds.toFloat().getCentre());
 
-    auto numChoices = labels.size();
-    for (int i = 0; i < numChoices; ++i) {
-        auto pos = labels[i].pos;
-        jassert(0.f <= pos && pos <= 1.f);
+    g.setColour(Colours::black);
+    g.fillRect(r);
 
-        auto ang = jmap(pos, 0.f, 1.f, startAng, endAng);
+    g.setColour(Colours::white);
+    g.drawFittedText(displayString, r.toNearestInt(), juce::Justification::centred, 1);
+}
+
+void RotarySliderWithLabels::resized() {
+    juce::Slider::resized();
+    imagesScale = 0; // the next paint takes the images for the new size
+}
 
-        auto labelCenter =
-            center.getPointOnCircumference(radius + getTextHeight() * 0.5f + 1.f, ang);
+void RotarySliderWithLabels::updateImages(float scale) {
+    using namespace juce;
+    imagesScale = scale;
 
-        Rectangle<float> r;
-        auto str = labels[i].label;
-        r.setSize(g.getCurrentFont().getStringWidth(str), getTextHeight());
-        r.setCentre(labelCenter);
-        r.setY(r.getY() + getTextHeight()); // shift down a bit
+    auto size = getSliderBounds().getWidth();
+    frameSize = jmax(1, roundToInt(size * scale));
 
-        g.drawFittedText(str, r.toNearestInt(), Justification::centred, 1);
+    if (frameSize > maxFrameSize) {
+        filmstrip = {};
+    } else {
+        String filmstripName("knob");
+        filmstripName << size;
+        filmstrip = resources->images.get(
+            filmstripName, frameSize * framesPerRow, frameSize * framesPerRow, 1.f,
+            [size, frameSize = frameSize](Graphics &fg) {
+                fg.addTransform(AffineTransform::scale(frameSize / float(size)));
+                for (int i = 0; i < numFrames; ++i) {
+                    auto ang = jmap(float(i), 0.f, float(numFrames - 1), startAng, endAng);
+                    auto frameBounds = Rectangle<float>((i % framesPerRow) * size,
+                                                        (i / framesPerRow) * size, size, size);
+                    drawKnob(fg, frameBounds.reduced(0.5f), ang);
+                }
+            });
     }
+
+    String labelsName("labels");
+    for (const auto &label : labels) labelsName << "_" << label.pos << label.label;
+
+    auto drawLabels = [this](Graphics &g) {
+        auto sliderBounds = getSliderBounds();
+        auto center = sliderBounds.toFloat().getCentre();
+        auto radius = sliderBounds.getWidth() * 0.5f;
+
+        g.setColour(Colour(0u, 172u, 1u));
+        g.setFont(getTextHeight());
+
+        auto numChoices = labels.size();
+        for (int i = 0; i < numChoices; ++i) {
+            auto pos = labels[i].pos;
+            jassert(0.f <= pos && pos <= 1.f);
+
+            auto ang = jmap(pos, 0.f, 1.f, startAng, endAng);
+
+            auto labelCenter =
+                center.getPointOnCircumference(radius + getTextHeight() * 0.5f + 1.f, ang);
+
+            Rectangle<float> r;
+            auto str = labels[i].label;
+            r.setSize(g.getCurrentFont().getStringWidth(str), getTextHeight());
+            r.setCentre(labelCenter);
+            r.setY(r.getY() + getTextHeight()); // shift down a bit
+
+            g.drawFittedText(str, r.toNearestInt(), Justification::centred, 1);
+        }
+    };
+    labelsImage = resources->images.get(labelsName, getWidth(), getHeight(), scale, drawLabels);
 }
 
 juce::Rectangle<int> RotarySliderWithLabels::getSliderBounds() const {
@@ -119,22 +176,17 @@ juce::Rectangle<int> RotarySliderWithLabels::getSliderBounds() const {
 }
 
 juce::String RotarySliderWithLabels::getDisplayString() const {
-    if (auto *choiceParam = dynamic_cast<juce::AudioParameterChoice *>(param))
-        return choiceParam->getCurrentChoiceName();
+    if (choiceParam != nullptr) return choiceParam->getCurrentChoiceName();
 
     juce::String str;
     bool addK = false; // display in khz?
 
-    if (auto *floatParam = dynamic_cast<juce::AudioParameterFloat *>(param)) {
-        float val = getValue();
-        if (val > 999.f) { // display in khz
-            val /= 1000.f;
-            addK = true;
-        }
-        str = juce::String(val, (addK ? 2 : 0)); // format into 2 decimals if displaying in khz
-    } else {
-        jassertfalse;
+    float val = getValue();
+    if (val > 999.f) { // display in khz
+        val /= 1000.f;
+        addK = true;
     }
+    str = juce::String(val, (addK ? 2 : 0)); // format into 2 decimals if displaying in khz
 
     // add suffix
     if (suffix.isNotEmpty()) {
@@ -148,93 +200,51 @@ juce::String RotarySliderWithLabels::getDisplayString() const {
 
 //==============================================================================
 ResponseCurveComponent::ResponseCurveComponent(SimpleEQAudioProcessor &p) : audioProcessor(p) {
-    // add listener
-    const auto &params = audioProcessor.getParameters();
-    for (auto param : params) { param->addListener(this); }
-
     // ensure to display the proper params
-    updateChain();
-
-    // start timer
-    startTimerHz(60);
+    audioProcessor.readCoefficientSnapshot(snapshot);
 }
 
-ResponseCurveComponent::~ResponseCurveComponent() {
-    // remove listener
-    const auto &params = audioProcessor.getParameters();
-    for (auto param : params) { param->removeListener(this); }
-}
-
-void ResponseCurveComponent::parameterValueChanged(int parameterIndex, float newValue) {
-    parametersChanged.set(true);
+void ResponseCurveComponent::updateShowing() {
+    if (!isShowing()) {
+        stopTimer();
+    } else if (!isTimerRunning()) {
+        if (audioProcessor.readCoefficientSnapshot(snapshot)) repaint();
+        startTimerHz(60);
+    }
 }
 
 void ResponseCurveComponent::timerCallback() {
-    if (parametersChanged.compareAndSetBool(false, true)) {
-        updateChain();
-        // signal a repaint
-        repaint();
-    }
-}
+    SIMPLEEQ_TRACE_SCOPE("ResponseCurveComponent::timerCallback");
 
-void ResponseCurveComponent::updateChain() {
-    // update the mono-chain
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
-    // peak filter
-    auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    // cut filters
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients,
-                    chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients,
-                    chainSettings.highCutSlope);
+    // only a new version of the coefficients needs a repaint
+    if (audioProcessor.readCoefficientSnapshot(snapshot)) repaint();
 }
 
 void ResponseCurveComponent::paint(juce::Graphics &g) {
+    SIMPLEEQ_TRACE_SCOPE("ResponseCurveComponent::paint");
+
     using namespace juce;
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll(Colours::black);
+
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != backgroundScale) {
+        backgroundScale = scale;
+        background = resources->images.get("grid", getWidth(), getHeight(), scale,
+                                           [this](Graphics &bg) { drawBackground(bg); });
+    }
     g.drawImage(background, getLocalBounds().toFloat());
 
     auto responseArea = getAnalysisArea();
 
     auto w = responseArea.getWidth();
 
-    auto &lowCut = monoChain.get<ChainPositions::LowCut>();
-    auto &peak = monoChain.get<ChainPositions::Peak>();
-    auto &highCut = monoChain.get<ChainPositions::HighCut>();
-
-    auto sampleRate = audioProcessor.getSampleRate();
-
     // calculate the corresponding height of each frequency chop
     std::vector<double> mags;
     mags.resize(w);
     for (int i = 0; i < w; ++i) {
-        double mag = 1.f;
         auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
-
-        if (!monoChain.isBypassed<ChainPositions::Peak>())
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-        if (!lowCut.isBypassed<0>())
-            mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowCut.isBypassed<1>())
-            mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowCut.isBypassed<2>())
-            mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!lowCut.isBypassed<3>())
-            mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-        if (!highCut.isBypassed<0>())
-            mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highCut.isBypassed<1>())
-            mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highCut.isBypassed<2>())
-            mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-        if (!highCut.isBypassed<3>())
-            mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
+        auto mag = snapshot.getMagnitudeForFrequency(freq);
 
         mags[i] = Decibels::gainToDecibels(mag);
     }
@@ -261,12 +271,8 @@ void ResponseCurveComponent::paint(juce::Graphics &g) {
     g.strokePath(responseCurve, PathStrokeType(2.f)); // the curve
 }
 
-void ResponseCurveComponent::resized() {
-    // create a background image for the
+void ResponseCurveComponent::drawBackground(juce::Graphics &g) {
     using namespace juce;
-    background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
-
-    Graphics g(background);
 
     Array<float> freqs{20,   /*30, 40, */ 50,       100,   200,  /*300, 400, */ 500, 1000,
                        2000, /*3000, 4000, */ 5000, 10000, 20000};
@@ -354,6 +360,110 @@ void ResponseCurveComponent::resized() {
     }
 }
 
+//==============================================================================
+static constexpr float meterFloor = -60.f, meterCeiling = 6.f;
+
+LevelMeterComponent::LevelMeterComponent(SimpleEQAudioProcessor &p) : audioProcessor(p) {
+    resetBars();
+}
+
+LevelMeterComponent::~LevelMeterComponent() { audioProcessor.setMeteringEnabled(false); }
+
+void LevelMeterComponent::updateShowing() {
+    auto showing = isShowing();
+    audioProcessor.setMeteringEnabled(showing);
+
+    if (!showing) {
+        stopTimer();
+    } else if (!isTimerRunning()) {
+        // whatever was measured before is out of date
+        resetBars();
+        startTimerHz(30);
+    }
+}
+
+void LevelMeterComponent::resetBars() {
+    std::fill(bars.begin(), bars.end(), Bar{meterFloor, meterFloor, meterFloor});
+}
+
+void LevelMeterComponent::timerCallback() {
+    using namespace juce;
+
+    // the peaks fall back at 20 dB/s
+    constexpr float fall = 20.f / 30.f;
+    auto toDecibels = [](float gain) { return Decibels::gainToDecibels(gain, meterFloor); };
+
+    auto &input = audioProcessor.getInputMeter();
+    auto &output = audioProcessor.getOutputMeter();
+
+    // the buses change with the host's layout, from mono up to maxMainChannels
+    auto numInputs = input.getNumChannels(), numOutputs = output.getNumChannels();
+    bool changed = numInputs != numInputBars || numInputs + numOutputs != (int)bars.size();
+    if (changed) {
+        numInputBars = numInputs;
+        bars.resize((size_t)(numInputs + numOutputs));
+        resetBars();
+    }
+
+    for (int i = 0; i < (int)bars.size(); ++i) {
+        auto levels = i < numInputBars ? input.read(i) : output.read(i - numInputBars);
+
+        auto &bar = bars[(size_t)i];
+        Bar next{jmax(toDecibels(levels.peak), bar.peak - fall), toDecibels(levels.rms),
+                 jmax(toDecibels(levels.truePeak), bar.truePeak - fall)};
+        next.peak = jmax(next.peak, meterFloor);
+        next.truePeak = jmax(next.truePeak, meterFloor);
+
+        changed |= next.peak != bar.peak || next.rms != bar.rms || next.truePeak != bar.truePeak;
+        bar = next;
+    }
+
+    if (changed) repaint();
+}
+
+void LevelMeterComponent::paint(juce::Graphics &g) {
+    using namespace juce;
+    g.fillAll(Colours::black);
+
+    auto bounds = getLocalBounds().reduced(2, 12).toFloat();
+    auto labels = bounds.removeFromBottom(12);
+    auto toY = [&bounds](float decibels) {
+        return jmap(decibels, meterFloor, meterCeiling, bounds.getBottom(), bounds.getY());
+    };
+
+    // a bar for each input channel, a gap, a bar for each output channel, with a pixel
+    // between bars unless there are too many to spare it
+    auto barWidth = bounds.getWidth() / (float)(bars.size() + 1);
+    auto spacing = jmin(1.f, barWidth / 4.f);
+    for (int i = 0; i < (int)bars.size(); ++i) {
+        auto x = bounds.getX() + barWidth * (float)(i < numInputBars ? i : i + 1);
+        auto &bar = bars[(size_t)i];
+        auto column =
+            Rectangle<float>(x, bounds.getY(), barWidth - spacing, bounds.getHeight());
+
+        g.setColour(Colours::darkgrey.darker());
+        g.fillRect(column);
+
+        g.setColour(Colour(0u, 172u, 1u));
+        g.fillRect(column.withTop(toY(bar.rms)));
+
+        g.setColour(Colours::white);
+        g.fillRect(column.withTop(toY(bar.peak)).withHeight(1.f));
+
+        g.setColour(bar.truePeak > 0.f ? Colours::red : Colours::orange);
+        g.fillRect(column.withTop(toY(bar.truePeak)).withHeight(1.f));
+    }
+
+    g.setColour(Colours::lightgrey);
+    g.setFont(10.f);
+    auto numOutputBars = (int)bars.size() - numInputBars;
+    g.drawFittedText("IN", labels.removeFromLeft(barWidth * (float)numInputBars).toNearestInt(),
+                     Justification::centred, 1);
+    g.drawFittedText("OUT",
+                     labels.removeFromRight(barWidth * (float)numOutputBars).toNearestInt(),
+                     Justification::centred, 1);
+}
+
 juce::Rectangle<int> ResponseCurveComponent::getRenderArea() {
     auto bounds = getLocalBounds();
 
@@ -374,22 +484,22 @@ juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea() {
 //==============================================================================
 SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcessor &p)
     : AudioProcessorEditor(&p), audioProcessor(p),
-      peakFreqSlider(*audioProcessor.apvts.getParameter("Peak Freq"), "Hz"),
-      peakGainSlider(*audioProcessor.apvts.getParameter("Peak Gain"), "dB"),
-      peakQualitySlider(*audioProcessor.apvts.getParameter("Peak Quality"), ""),
-      lowCutFreqSlider(*audioProcessor.apvts.getParameter("LowCut Freq"), "Hz"),
-      highCutFreqSlider(*audioProcessor.apvts.getParameter("HighCut Freq"), "Hz"),
-      lowCutSlopeSlider(*audioProcessor.apvts.getParameter("LowCut Slope"), "dB/Oct"),
-      highCutSlopeSlider(*audioProcessor.apvts.getParameter("HighCut Slope"), "db/Oct"),
-
-      responseCurveComponent(audioProcessor),
-      peakFreqSliderAttachment(audioProcessor.apvts, "Peak Freq", peakFreqSlider),
-      peakGainSliderAttachment(audioProcessor.apvts, "Peak Gain", peakGainSlider),
-      peakQualitySliderAttachment(audioProcessor.apvts, "Peak Quality", peakQualitySlider),
-      lowCutFreqSliderAttachment(audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
-      highCutFreqSliderAttachment(audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
-      lowCutSlopeSliderAttachment(audioProcessor.apvts, "LowCut Slope", lowCutSlopeSlider),
-      highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSlider) {
+      peakFreqSlider(getParameter(Param::PeakFreq), "Hz"),
+      peakGainSlider(getParameter(Param::PeakGain), "dB"),
+      peakQualitySlider(getParameter(Param::PeakQuality), ""),
+      lowCutFreqSlider(getParameter(Param::LowCutFreq), "Hz"),
+      highCutFreqSlider(getParameter(Param::HighCutFreq), "Hz"),
+      lowCutSlopeSlider(getParameter(Param::LowCutSlope), "dB/Oct"),
+      highCutSlopeSlider(getParameter(Param::HighCutSlope), "db/Oct"),
+
+      responseCurveComponent(audioProcessor), levelMeterComponent(audioProcessor),
+      peakFreqSliderAttachment(makeAttachment(Param::PeakFreq, peakFreqSlider)),
+      peakGainSliderAttachment(makeAttachment(Param::PeakGain, peakGainSlider)),
+      peakQualitySliderAttachment(makeAttachment(Param::PeakQuality, peakQualitySlider)),
+      lowCutFreqSliderAttachment(makeAttachment(Param::LowCutFreq, lowCutFreqSlider)),
+      highCutFreqSliderAttachment(makeAttachment(Param::HighCutFreq, highCutFreqSlider)),
+      lowCutSlopeSliderAttachment(makeAttachment(Param::LowCutSlope, lowCutSlopeSlider)),
+      highCutSlopeSliderAttachment(makeAttachment(Param::HighCutSlope, highCutSlopeSlider)) {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
 
@@ -415,15 +525,39 @@ SimpleEQAudioProcessorEditor::SimpleEQAudioProcessorEditor(SimpleEQAudioProcesso
     highCutSlopeSlider.labels.add({0.f, "12"});
     highCutSlopeSlider.labels.add({1.f, "48"});
 
+    // programs
+    for (int i = 0; i < audioProcessor.getNumPrograms(); ++i)
+        programSelector.addItem(audioProcessor.getProgramName(i), i + 1);
+    programSelector.setSelectedId(audioProcessor.getCurrentProgram() + 1,
+                                  juce::dontSendNotification);
+    programSelector.onChange = [this] {
+        audioProcessor.setCurrentProgram(programSelector.getSelectedId() - 1);
+    };
+    startTimerHz(10);
+
+    stereoModeAttachment = makeChoiceAttachment(Param::StereoMode, stereoModeSelector);
+    topologyAttachment = makeChoiceAttachment(Param::FilterTopology, topologySelector);
+
     // make components visible
     for (auto *comp : getComps()) { addAndMakeVisible(comp); }
 
     setSize(600, 480);
 }
 
-SimpleEQAudioProcessorEditor::~SimpleEQAudioProcessorEditor() {}
+SimpleEQAudioProcessorEditor::~SimpleEQAudioProcessorEditor() {
+#if SIMPLEEQ_ENABLE_TRACING
+    // closing the editor is the moment to look at what just happened
+    TraceProfiler::writeTo(TraceProfiler::getDefaultFile());
+#endif
+}
 
 //==============================================================================
+void SimpleEQAudioProcessorEditor::timerCallback() {
+    auto selectedId = audioProcessor.getCurrentProgram() + 1;
+    if (programSelector.getSelectedId() != selectedId)
+        programSelector.setSelectedId(selectedId, juce::dontSendNotification);
+}
+
 void SimpleEQAudioProcessorEditor::paint(juce::Graphics &g) {
     using namespace juce;
     // (Our component is opaque, so we must completely fill the background with a solid colour)
@@ -435,9 +569,17 @@ void SimpleEQAudioProcessorEditor::resized() {
     // subcomponents in your editor..
 
     auto bounds = getLocalBounds();
+    auto topStrip = bounds.removeFromTop(24).reduced(20, 2);
+    stereoModeSelector.setBounds(topStrip.removeFromRight(120));
+    topStrip.removeFromRight(10);
+    topologySelector.setBounds(topStrip.removeFromRight(80));
+    topStrip.removeFromRight(10);
+    programSelector.setBounds(topStrip);
+
     float hRatio = 25.f / 100.f; // JUCE_LIVE_CONSTANT(33) / 100.f; // change lively
     auto responseArea = bounds.removeFromTop(bounds.getHeight() * hRatio);
 
+    levelMeterComponent.setBounds(responseArea.removeFromRight(60));
     responseCurveComponent.setBounds(responseArea);
 
     bounds.removeFromTop(5); // give some gaps
@@ -455,7 +597,27 @@ void SimpleEQAudioProcessorEditor::resized() {
     peakQualitySlider.setBounds(bounds);
 }
 
+juce::RangedAudioParameter &SimpleEQAudioProcessorEditor::getParameter(Param param) {
+    return *audioProcessor.apvts.getParameter(getParamID(param));
+}
+
+SimpleEQAudioProcessorEditor::Attachment
+SimpleEQAudioProcessorEditor::makeAttachment(Param param, juce::Slider &slider) {
+    return Attachment(audioProcessor.apvts, getParamID(param), slider);
+}
+
+std::unique_ptr<SimpleEQAudioProcessorEditor::APVTS::ComboBoxAttachment>
+SimpleEQAudioProcessorEditor::makeChoiceAttachment(Param param, juce::ComboBox &comboBox) {
+    // the items have to be there before the attachment syncs to the parameter
+    auto &spec = getParamSpec(param);
+    for (int i = 0; i < spec.numChoices; ++i) comboBox.addItem(spec.choices[i], i + 1);
+    return std::make_unique<APVTS::ComboBoxAttachment>(audioProcessor.apvts, getParamID(param),
+                                                       comboBox);
+}
+
 std::vector<juce::Component *> SimpleEQAudioProcessorEditor::getComps() {
-    return {&responseCurveComponent, &peakFreqSlider,    &peakGainSlider,    &peakQualitySlider,
-            &lowCutFreqSlider,       &highCutFreqSlider, &lowCutSlopeSlider, &highCutSlopeSlider};
+    return {&programSelector,        &topologySelector,    &stereoModeSelector,
+            &responseCurveComponent, &levelMeterComponent, &peakFreqSlider,
+            &peakGainSlider,         &peakQualitySlider,   &lowCutFreqSlider,
+            &highCutFreqSlider,      &lowCutSlopeSlider,   &highCutSlopeSlider};
 }
@@ -9,24 +9,19 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "SharedImageCache.h"
 #include <JuceHeader.h>
 
-struct MyLookAndFeel : juce::LookAndFeel_V4 {
-    // implement DrawRotarySlider
-    void drawRotarySlider(juce::Graphics &g, int x, int y, int width, int height,
-                          float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle,
-                          juce::Slider &slider) override;
+// everything that looks the same in every editor, shared by all of them in the process
+struct SharedEditorResources {
+    SharedImageCache images;
 };
 
 struct RotarySliderWithLabels : juce::Slider {
     RotarySliderWithLabels(juce::RangedAudioParameter &rap, const juce::String &unitSuffix)
         : juce::Slider(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag,
                        juce::Slider::TextEntryBoxPosition::NoTextBox),
-          param(&rap), suffix(unitSuffix) {
-        setLookAndFeel(&lnf);
-    }
-
-    ~RotarySliderWithLabels() override { setLookAndFeel(nullptr); }
+          choiceParam(dynamic_cast<juce::AudioParameterChoice *>(&rap)), suffix(unitSuffix) {}
 
     // show labels
     struct LabelPos {
@@ -36,50 +31,95 @@ struct RotarySliderWithLabels : juce::Slider {
     juce::Array<LabelPos> labels;
 
     void paint(juce::Graphics &g) override;
+    void resized() override;
     juce::Rectangle<int> getSliderBounds() const;
     static int getTextHeight() { return 14; }
     juce::String getDisplayString() const;
 
   private:
-    MyLookAndFeel lnf;
+    juce::SharedResourcePointer<SharedEditorResources> resources;
 
-    juce::RangedAudioParameter *param;
+    juce::AudioParameterChoice *choiceParam; // nullptr for float parameters
     juce::String suffix;
+
+    // the value text only changes with the value
+    double displayedValue{std::numeric_limits<double>::quiet_NaN()};
+    juce::String displayString;
+    int displayStringWidth{0};
+
+    // What paint() draws, taken from the shared cache only when the size or the
+    // display scale has changed. The filmstrip is null for knobs too big for one.
+    juce::Image labelsImage, filmstrip;
+    int frameSize{0}; // of the filmstrip, in physical pixels
+    float imagesScale{0};
+    void updateImages(float scale);
+
+    // the knob without its value, for the filmstrips and the knobs too big for them
+    static void drawKnob(juce::Graphics &g, juce::Rectangle<float> bounds, float angle);
 };
 
-struct ResponseCurveComponent : juce::Component,
-                                juce::AudioProcessorParameter::Listener,
-                                juce::Timer {
+struct ResponseCurveComponent : juce::Component, juce::Timer {
     explicit ResponseCurveComponent(SimpleEQAudioProcessor &);
-    ~ResponseCurveComponent() override;
 
-    void parameterValueChanged(int parameterIndex, float newValue) override;
-    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override {}
     void timerCallback() override;
 
     void paint(juce::Graphics &g) override; // change every time
-    void resized() override;                // preset before any actions
+    void resized() override { backgroundScale = 0; }
+
+    // polls the processor only while on screen
+    void visibilityChanged() override { updateShowing(); }
+    void parentHierarchyChanged() override { updateShowing(); }
+
   private:
     SimpleEQAudioProcessor &audioProcessor;
+    juce::SharedResourcePointer<SharedEditorResources> resources;
 
-    // need an atomic bool to ensure threads security
-    juce::Atomic<bool> parametersChanged{false};
-
-    MonoChain monoChain;
+    // what the audio thread applies, published by the processor
+    CoefficientSnapshot snapshot;
 
-    void updateChain();
+    void updateShowing();
 
+    // the grid and its labels, pre-rendered once per size in the shared cache and
+    // taken from it only when the size or the display scale has changed
     juce::Image background;
+    float backgroundScale{0};
+    void drawBackground(juce::Graphics &g);
 
     juce::Rectangle<int> getRenderArea(); // slightly smaller than the getLocalBounds()
 
     juce::Rectangle<int> getAnalysisArea(); // slightly smaller than the getRenderArea()
 };
 
+// Input and output levels. Metering is only switched on while this is on screen.
+struct LevelMeterComponent : juce::Component, juce::Timer {
+    explicit LevelMeterComponent(SimpleEQAudioProcessor &);
+    ~LevelMeterComponent() override;
+
+    void timerCallback() override;
+    void paint(juce::Graphics &g) override;
+
+    void visibilityChanged() override { updateShowing(); }
+    void parentHierarchyChanged() override { updateShowing(); }
+
+  private:
+    SimpleEQAudioProcessor &audioProcessor;
+
+    // what is displayed, in dB, the input's channels and then the output's, as many
+    // as the buses had in the last block
+    struct Bar {
+        float peak, rms, truePeak;
+    };
+    std::vector<Bar> bars;
+    int numInputBars{0};
+
+    void updateShowing();
+    void resetBars();
+};
+
 //==============================================================================
 /**
  */
-class SimpleEQAudioProcessorEditor : public juce::AudioProcessorEditor {
+class SimpleEQAudioProcessorEditor : public juce::AudioProcessorEditor, juce::Timer {
   public:
     explicit SimpleEQAudioProcessorEditor(SimpleEQAudioProcessor &);
     ~SimpleEQAudioProcessorEditor() override;
@@ -88,6 +128,9 @@ class SimpleEQAudioProcessorEditor : public juce::AudioProcessorEditor {
     void paint(juce::Graphics &) override;
     void resized() override;
 
+    // follows the program the host has switched to
+    void timerCallback() override;
+
   private:
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -97,12 +140,22 @@ class SimpleEQAudioProcessorEditor : public juce::AudioProcessorEditor {
         highCutFreqSlider, lowCutSlopeSlider, highCutSlopeSlider;
 
     ResponseCurveComponent responseCurveComponent;
+    LevelMeterComponent levelMeterComponent;
+
+    juce::ComboBox programSelector, topologySelector, stereoModeSelector;
 
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
     Attachment peakFreqSliderAttachment, peakGainSliderAttachment, peakQualitySliderAttachment,
         lowCutFreqSliderAttachment, highCutFreqSliderAttachment, lowCutSlopeSliderAttachment,
         highCutSlopeSliderAttachment;
+    std::unique_ptr<APVTS::ComboBoxAttachment> stereoModeAttachment, topologyAttachment;
+
+    juce::RangedAudioParameter &getParameter(Param param);
+    Attachment makeAttachment(Param param, juce::Slider &slider);
+    // fills the combo box with the parameter's choices
+    std::unique_ptr<APVTS::ComboBoxAttachment> makeChoiceAttachment(Param param,
+                                                                    juce::ComboBox &comboBox);
 
     std::vector<juce::Component *> getComps();
 
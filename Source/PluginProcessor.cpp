@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "TraceProfiler.h"
 
 //==============================================================================
 SimpleEQAudioProcessor::SimpleEQAudioProcessor()
@@ -16,6 +17,7 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
 #if !JucePlugin_IsMidiEffect
 #if !JucePlugin_IsSynth
                          .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                         .withInput("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
                          .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
@@ -24,7 +26,12 @@ SimpleEQAudioProcessor::SimpleEQAudioProcessor()
 {
 }
 
-SimpleEQAudioProcessor::~SimpleEQAudioProcessor() {}
+SimpleEQAudioProcessor::~SimpleEQAudioProcessor() {
+#if SIMPLEEQ_VERIFY_FAST_PATHS
+    pathVerifier.finish();
+    pathVerifier.writeTo(PathVerifier::getDefaultFile());
+#endif
+}
 
 //==============================================================================
 const juce::String SimpleEQAudioProcessor::getName() const { return JucePlugin_Name; }
@@ -55,21 +62,43 @@ bool SimpleEQAudioProcessor::isMidiEffect() const {
 
 double SimpleEQAudioProcessor::getTailLengthSeconds() const { return 0.0; }
 
-int SimpleEQAudioProcessor::getNumPrograms() {
-    return 1; // NB: some hosts don't cope very well if you tell them there are 0 programs,
-    // so this should be at least 1, even if you're not really implementing programs.
-}
+int SimpleEQAudioProcessor::getNumPrograms() { return ProgramBank::numPrograms; }
+
+int SimpleEQAudioProcessor::getCurrentProgram() { return currentProgram; }
 
-int SimpleEQAudioProcessor::getCurrentProgram() { return 0; }
+void SimpleEQAudioProcessor::setCurrentProgram(int index) {
+    if (!juce::isPositiveAndBelow(index, ProgramBank::numPrograms)) return;
 
-void SimpleEQAudioProcessor::setCurrentProgram(int index) {}
+    currentProgram = index;
+    // Until all of the program's parameters are in place, the audio thread leaves
+    // their changes alone rather than applying some of them to the outgoing chains.
+    pendingProgram = programBeingSet;
+    setParameters(programBank.getSettings(index));
+    pendingProgram = index;
+}
+
+int SimpleEQAudioProcessor::takePendingProgram() {
+    auto program = pendingProgram.load();
+    // a failed exchange has loaded whatever setCurrentProgram() has written since
+    while (program >= 0 && !pendingProgram.compare_exchange_weak(program, -1)) {
+    }
+    return program;
+}
 
-const juce::String SimpleEQAudioProcessor::getProgramName(int index) { return {}; }
+const juce::String SimpleEQAudioProcessor::getProgramName(int index) {
+    if (!juce::isPositiveAndBelow(index, ProgramBank::numPrograms)) return {};
+    return programBank.getName(index);
+}
 
-void SimpleEQAudioProcessor::changeProgramName(int index, const juce::String &newName) {}
+void SimpleEQAudioProcessor::changeProgramName(int index, const juce::String &newName) {
+    if (juce::isPositiveAndBelow(index, ProgramBank::numPrograms))
+        programBank.setName(index, newName);
+}
 
 //==============================================================================
 void SimpleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    SIMPLEEQ_TRACE_SCOPE("prepareToPlay");
+
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
@@ -79,12 +108,64 @@ void SimpleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
 
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    for (auto &chain : leftChains) chain.prepare(spec);
+    for (auto &chain : rightChains) chain.prepare(spec);
 
-    auto chainSettings = getChainSettings(apvts);
+    // redesigns the programs in the background if the rate has changed
+    programBank.prepare(sampleRate);
+
+    auto numMainChannels = getMainBusNumOutputChannels();
+    auto numWide = numMainChannels > 2 ? numMainChannels : 0;
+    if (numWide != numWideChains) {
+        wideChains = numWide > 0 ? std::make_unique<MonoChain[]>((size_t)numWide) : nullptr;
+        numWideChains = numWide;
+        preparedSampleRate = 0; // the new chains need designing
+    }
+    for (int i = 0; i < numWideChains; ++i) wideChains[i].prepare(spec);
+
+    // threads only for processes that render offline, started here and not on the
+    // audio thread, waiting for another instance's render if there is one
+    if (numWideChains > 0 && isNonRealtime()) {
+        auto &shared = *sharedRenderer;
+        const juce::SpinLock::ScopedLockType lock(shared.lock);
+        if (!shared.renderer.isRunning())
+            shared.renderer.start(juce::SystemStats::getNumCpus() - 1);
+    }
 
-    updateAllFilters();
+    for (auto &chain : svfChains) chain.reset();
+    dynamicPeakGain.prepare(sampleRate);
+    peakGainBuffer.setSize(1, samplesPerBlock);
+
+    inputMeter.prepare(sampleRate);
+    outputMeter.prepare(sampleRate);
+    SIMPLEEQ_VERIFY(pathVerifier.prepare(sampleRate, samplesPerBlock));
+
+    fadeBuffer.setSize(2, samplesPerBlock);
+    programFade.reset(sampleRate, 0.02);
+    programFade.setCurrentAndTargetValue(1.f);
+
+    // Hosts prepare again and again at the same rate, the designs from last time
+    // are still good then and only the changes since need applying.
+    if (sampleRate != preparedSampleRate) {
+        preparedSampleRate = sampleRate;
+
+        // the idle pair too, which the audio thread loads a program into
+        auto primingSet = makePrimingSet(parameters.getChainSettings(), sampleRate);
+        for (auto &chain : leftChains) applyCoefficientSet(chain, primingSet);
+        for (auto &chain : rightChains) applyCoefficientSet(chain, primingSet);
+        for (int i = 0; i < numWideChains; ++i) applyCoefficientSet(wideChains[i], primingSet);
+
+        // the filters size their state to their order on reset(), which would
+        // otherwise happen on the audio thread, the first time each chain runs
+        for (auto &chain : leftChains) chain.reset();
+        for (auto &chain : rightChains) chain.reset();
+        for (int i = 0; i < numWideChains; ++i) wideChains[i].reset();
+
+        updateAllFilters();
+    } else {
+        updateChangedFilters();
+    }
+    coefficientSnapshots.publish(leftChains[activeChain], sampleRate);
 }
 
 void SimpleEQAudioProcessor::releaseResources() {
@@ -100,16 +181,19 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts)
     return true;
 #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-        layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    // Mono, stereo, or any wider bus, e.g. stems or ambisonics, up to maxMainChannels.
+    auto mainOutput = layouts.getMainOutputChannelSet();
+    if (mainOutput.isDisabled() || mainOutput.size() > maxMainChannels) return false;
 
         // This checks if the input layout matches the output layout
 #if !JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet()) return false;
+
+    // the optional sidechain only drives the peak's dynamic gain
+    auto sidechain = layouts.getChannelSet(true, 1);
+    if (!sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono() &&
+        sidechain != juce::AudioChannelSet::stereo())
+        return false;
 #endif
 
     return true;
@@ -118,8 +202,41 @@ bool SimpleEQAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts)
 
 #endif
 
+static void processStereo(MonoChain &leftChain, MonoChain &rightChain,
+                          juce::dsp::AudioBlock<float> &block, StereoMode stereoMode) {
+    SIMPLEEQ_TRACE_SCOPE("processStereo");
+
+    auto leftBlock = block.getSingleChannelBlock(0);
+    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
+
+    // a mono bus has no side, the left chain runs on its one channel
+    if (block.getNumChannels() == 1) {
+        leftChain.process(leftContext);
+        return;
+    }
+
+    auto rightBlock = block.getSingleChannelBlock(1);
+    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+
+    if (stereoMode == StereoMode::Stereo) {
+        leftChain.process(leftContext);
+        rightChain.process(rightContext);
+        return;
+    }
+
+    auto *left = leftBlock.getChannelPointer(0);
+    auto *right = rightBlock.getChannelPointer(0);
+    auto numSamples = (int)block.getNumSamples();
+
+    encodeMidSide(left, right, numSamples);
+    if (stereoMode != StereoMode::SideOnly) leftChain.process(leftContext);
+    if (stereoMode != StereoMode::MidOnly) rightChain.process(rightContext);
+    decodeMidSide(left, right, numSamples);
+}
+
 void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                           juce::MidiBuffer &midiMessages) {
+    SIMPLEEQ_TRACE_SCOPE("processBlock");
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -133,20 +250,243 @@ void SimpleEQAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    auto chainSettings = getChainSettings(apvts);
+    // the only cost of metering while no editor shows it
+    auto metering = meteringEnabled.load(std::memory_order_relaxed);
+    if (metering)
+        inputMeter.measure(buffer.getArrayOfReadPointers(), getMainBusNumInputChannels(),
+                           buffer.getNumSamples());
+
+    // the main bus only, not the sidechain's channels that may follow it
+    SIMPLEEQ_VERIFY(pathVerifier.capture(getBusBuffer(buffer, true, 0)));
+    auto matchesReference = processFilters(buffer);
+    SIMPLEEQ_VERIFY(verifyBlock(getBusBuffer(buffer, false, 0), matchesReference));
+    juce::ignoreUnused(matchesReference);
+
+    if (metering)
+        outputMeter.measure(buffer.getArrayOfReadPointers(), getMainBusNumOutputChannels(),
+                            buffer.getNumSamples());
+}
+
+bool SimpleEQAudioProcessor::processFilters(juce::AudioBuffer<float> &buffer) {
+    auto program = takePendingProgram();
+    if (numWideChains > 0) {
+        // no crossfades here, a program arrives as parameter changes
+        if (program != programBeingSet) updateChangedFilters();
+        coefficientSnapshots.publish(wideChains[0], getSampleRate());
+        processWide(buffer);
+        return false;
+    }
 
-    updateAllFilters();
+    auto stereoMode = parameters.getStereoMode();
+    auto topology = parameters.getFilterTopology();
+    if (topology != appliedTopology) {
+        // the filters that take over have been idle, their state is stale
+        appliedTopology = topology;
+        programFade.setCurrentAndTargetValue(1.f);
+        if (topology == FilterTopology::Svf) {
+            for (auto &chain : svfChains) chain.reset();
+            dynamicPeakGain.reset();
+        } else {
+            leftChains[activeChain].reset();
+            rightChains[activeChain].reset();
+        }
+        SIMPLEEQ_VERIFY(pathVerifier.reset());
+    }
 
-    juce::dsp::AudioBlock<float> block(buffer);
+    // the SVFs take the program's parameter changes without a fade
+    if (program >= 0 && topology == FilterTopology::Biquad)
+        beginProgramFade(program, buffer.getNumSamples(), stereoMode);
 
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
+    if (programFade.isSmoothing()) {
+        // the incoming program keeps its precomputed coefficients until it has faded in
+        coefficientSnapshots.publish(leftChains[activeChain], getSampleRate());
+        processProgramFade(buffer, stereoMode);
+        return false;
+    }
 
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    // the outgoing program's chains keep their settings until the switch is ready,
+    // which leaves them behind the parameters for now
+    auto upToDate = program != programBeingSet;
+    if (upToDate) updateChangedFilters();
+    // the biquads have the same static response as the SVFs, the curve is drawn from them
+    coefficientSnapshots.publish(leftChains[activeChain], getSampleRate());
+
+    if (topology == FilterTopology::Svf) {
+        processSvf(buffer, stereoMode);
+        return upToDate && parameters.get<Param::PeakDynamicRange>() == 0.f;
+    }
 
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    // the main bus only, a mono one is followed by the sidechain's channels
+    auto block = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(
+        0, (size_t)getMainBusNumOutputChannels());
+    processStereo(leftChains[activeChain], rightChains[activeChain], block, stereoMode);
+    return upToDate;
+}
+
+#if SIMPLEEQ_VERIFY_FAST_PATHS
+void SimpleEQAudioProcessor::verifyBlock(const juce::AudioBuffer<float> &buffer,
+                                         bool matchesReference) {
+    auto *tolerances = parameters.getFilterTopology() == FilterTopology::Svf
+                           ? &PathVerifier::svfTolerances
+                           : &PathVerifier::biquadTolerances;
+    pathVerifier.check(buffer, parameters.getChainSettings(), parameters.getSideChainSettings(),
+                       parameters.getStereoMode(), matchesReference ? tolerances : nullptr);
+}
+#endif
+
+void SimpleEQAudioProcessor::beginProgramFade(int index, int numSamples, StereoMode stereoMode) {
+    auto *coefficientSet = programBank.getCoefficientSet(index);
+    // not designed yet, the parameters have been set so the normal update takes over
+    if (coefficientSet == nullptr) return;
+
+    // the incoming program takes the idle pair, or the outgoing pair of an unfinished fade
+    activeChain = 1 - activeChain;
+    auto &leftChain = leftChains[activeChain];
+    auto &rightChain = rightChains[activeChain];
+    applyCoefficientSet(leftChain, *coefficientSet);
+    // programs only set the main parameters, the side keeps its own settings
+    if (stereoMode == StereoMode::MidSide)
+        copyCoefficients(rightChain, rightChains[1 - activeChain]);
+    else
+        applyCoefficientSet(rightChain, *coefficientSet);
+    leftChain.reset();
+    rightChain.reset();
+    SIMPLEEQ_VERIFY(pathVerifier.reset());
+
+    // The program's own parameter changes are already applied. Whatever else the
+    // host has changed (the side, the stereo mode) is left to the next update.
+    parameters.consumeChanges<Param::LowCutFreq, Param::HighCutFreq, Param::PeakFreq,
+                              Param::PeakGain, Param::PeakQuality, Param::LowCutSlope,
+                              Param::HighCutSlope>(appliedGenerations);
+    updateSvfFilters({true, true, true}, {true, true, true});
+
+    // the host broke its promise on the block size, switch without fading
+    if (numSamples > fadeBuffer.getNumSamples()) return;
+
+    programFade.setCurrentAndTargetValue(0.f);
+    programFade.setTargetValue(1.f);
+}
+
+void SimpleEQAudioProcessor::processProgramFade(juce::AudioBuffer<float> &buffer,
+                                                StereoMode stereoMode) {
+    SIMPLEEQ_TRACE_SCOPE("processProgramFade");
+
+    auto numSamples = buffer.getNumSamples();
+    auto numChannels = getMainBusNumOutputChannels();
+    auto outgoing = 1 - activeChain;
+
+    auto block =
+        juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, (size_t)numChannels);
+
+    // the host broke its promise on the block size in the middle of the fade, the
+    // incoming program takes over now
+    if (numSamples > fadeBuffer.getNumSamples()) {
+        programFade.setCurrentAndTargetValue(1.f);
+        processStereo(leftChains[activeChain], rightChains[activeChain], block, stereoMode);
+        return;
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        fadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+    auto fadeBlock = juce::dsp::AudioBlock<float>(fadeBuffer)
+                         .getSubsetChannelBlock(0, (size_t)numChannels)
+                         .getSubBlock(0, (size_t)numSamples);
+
+    processStereo(leftChains[activeChain], rightChains[activeChain], block, stereoMode);
+    processStereo(leftChains[outgoing], rightChains[outgoing], fadeBlock, stereoMode);
+
+    auto *left = buffer.getWritePointer(0);
+    auto *right = numChannels > 1 ? buffer.getWritePointer(1) : nullptr;
+    auto *fadeLeft = fadeBuffer.getReadPointer(0);
+    auto *fadeRight = fadeBuffer.getReadPointer(1);
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto gain = programFade.getNextValue();
+        left[i] = fadeLeft[i] + gain * (left[i] - fadeLeft[i]);
+        if (right != nullptr) right[i] = fadeRight[i] + gain * (right[i] - fadeRight[i]);
+    }
+}
+
+// the loudest channel of the detector, sample by sample
+static void computeDetectorLevels(const juce::AudioBuffer<float> &detector, float *levels,
+                                  int numSamples) {
+    juce::FloatVectorOperations::abs(levels, detector.getReadPointer(0), numSamples);
+    for (int channel = 1; channel < detector.getNumChannels(); ++channel) {
+        auto *samples = detector.getReadPointer(channel);
+        for (int i = 0; i < numSamples; ++i)
+            levels[i] = juce::jmax(levels[i], std::abs(samples[i]));
+    }
+}
+
+void SimpleEQAudioProcessor::processSvf(juce::AudioBuffer<float> &buffer, StereoMode stereoMode) {
+    SIMPLEEQ_TRACE_SCOPE("processSvf");
+
+    auto numSamples = buffer.getNumSamples();
+
+    // nullptr keeps the peak static, which costs no more than the biquads' fixed gain
+    const float *peakGains = nullptr;
+    auto range = parameters.get<Param::PeakDynamicRange>();
+    if (range != 0.f && numSamples <= peakGainBuffer.getNumSamples()) {
+        SIMPLEEQ_TRACE_SCOPE("dynamicPeakGain");
+
+        auto *levels = peakGainBuffer.getWritePointer(0);
+        // the input itself, before the EQ, when the host doesn't feed the sidechain
+        auto sidechain = getBusBuffer(buffer, true, 1);
+        if (sidechain.getNumChannels() > 0)
+            computeDetectorLevels(sidechain, levels, numSamples);
+        else
+            computeDetectorLevels(getBusBuffer(buffer, true, 0), levels, numSamples);
+
+        dynamicPeakGain.setParameters(range, parameters.get<Param::PeakDynamicThreshold>(),
+                                      parameters.get<Param::PeakDynamicAttack>(),
+                                      parameters.get<Param::PeakDynamicRelease>());
+        dynamicPeakGain.process(levels, numSamples);
+        peakGains = levels;
+    }
+
+    auto *left = buffer.getWritePointer(0);
+    // a mono main bus has no side, and its next channel is the sidechain's
+    if (getMainBusNumOutputChannels() == 1) {
+        svfChains[0].process(left, numSamples, peakGains);
+        return;
+    }
+
+    auto *right = buffer.getWritePointer(1);
+    auto midSide = stereoMode != StereoMode::Stereo;
+
+    if (midSide) encodeMidSide(left, right, numSamples);
+    if (stereoMode != StereoMode::SideOnly) svfChains[0].process(left, numSamples, peakGains);
+    if (stereoMode != StereoMode::MidOnly) svfChains[1].process(right, numSamples, peakGains);
+    if (midSide) decodeMidSide(left, right, numSamples);
+}
+
+void SimpleEQAudioProcessor::processWide(juce::AudioBuffer<float> &buffer) {
+    SIMPLEEQ_TRACE_SCOPE("processWide");
+
+    juce::dsp::AudioBlock<float> block(buffer);
+    auto numChannels = juce::jmin(numWideChains, getMainBusNumOutputChannels());
+    auto processChannel = [this, &block](int channel) {
+        auto channelBlock = block.getSingleChannelBlock((size_t)channel);
+        juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+        wideChains[channel].process(context);
+    };
+
+    // Every channel has its own chain and is processed by one thread only, so this
+    // is bit for bit what the serial loop makes of it. Realtime stays on the audio
+    // thread, blocking it on other threads would risk dropouts. The workers are
+    // started by prepareToPlay(), a host that goes offline without preparing again
+    // gets the serial loop.
+    if (isNonRealtime()) {
+        auto &shared = *sharedRenderer;
+        const juce::SpinLock::ScopedTryLockType lock(shared.lock);
+        if (lock.isLocked() && shared.renderer.isRunning()) {
+            shared.renderer.run(numChannels, processChannel);
+            return;
+        }
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel) processChannel(channel);
 }
 
 //==============================================================================
@@ -166,106 +506,162 @@ void SimpleEQAudioProcessor::getStateInformation(juce::MemoryBlock &destData) {
     // as intermediaries to make it easy to save and load complex data.
 
     juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    auto state = apvts.copyState();
+    state.setProperty(currentProgramID, currentProgram.load(), nullptr);
+    state.writeToStream(mos);
 }
 
 void SimpleEQAudioProcessor::setStateInformation(const void *data, int sizeInBytes) {
+    SIMPLEEQ_TRACE_SCOPE("setStateInformation");
+
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if (tree.isValid()) {
-        apvts.replaceState(tree);
-        updateAllFilters();
-    }
+    if (!tree.isValid()) return;
+
+    // only the index, the parameters saved with it may have been edited since
+    auto program = (int)tree.getProperty(currentProgramID, 0);
+    if (juce::isPositiveAndBelow(program, ProgramBank::numPrograms)) currentProgram = program;
+
+    // the audio thread picks the new values up as parameter changes
+    apvts.replaceState(tree);
 }
 
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts) {
-    ChainSettings settings;
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
-    return settings;
+void SimpleEQAudioProcessor::setParameters(const ChainSettings &chainSettings) {
+    auto set = [this](Param param, float value) {
+        auto *parameter = apvts.getParameter(getParamID(param));
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+    set(Param::LowCutFreq, chainSettings.lowCutFreq);
+    set(Param::HighCutFreq, chainSettings.highCutFreq);
+    set(Param::PeakFreq, chainSettings.peakFreq);
+    set(Param::PeakGain, chainSettings.peakGainInDecibels);
+    set(Param::PeakQuality, chainSettings.peakQuality);
+    set(Param::LowCutSlope, static_cast<float>(chainSettings.lowCutSlope));
+    set(Param::HighCutSlope, static_cast<float>(chainSettings.highCutSlope));
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
 SimpleEQAudioProcessor::createParameterLayout() {
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "LowCut Freq", "LowCut Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
-        20.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "HighCut Freq", "HighCut Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
-        20000.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "Peak Freq", "Peak Freq", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
-        750.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "Peak Gain", "Peak Gain", juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f), 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        "Peak Quality", "Peak Quality", juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
-        1.f));
-
-    juce::StringArray stringArray;
-    for (int i = 0; i < 4; ++i) {
-        juce::String str;
-        str << (12 + i * 12);
-        str << " db/Oct";
-        stringArray.add(str);
-    }
-    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope",
-                                                            stringArray, 0));
-    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope",
-                                                            stringArray, 0));
-
-    return layout;
+    return Parameters::createLayout();
 }
 
-void updateCoefficients(Coefficients &old, const Coefficients &replacements) {
-    *old = *replacements;
+void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings,
+                                              Chains chains) {
+    auto peakCoefficients = designPeak(chainSettings, getSampleRate());
+
+    for (auto *chain : chains)
+        setCoefficients(chain->get<ChainPositions::Peak>(), peakCoefficients);
 }
 
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate) {
-    // it's on the heap
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-        sampleRate, chainSettings.peakFreq, chainSettings.peakQuality,
-        juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings,
+                                                 Chains chains) {
+    auto cutDesign = designLowCut(chainSettings, getSampleRate());
+
+    for (auto *chain : chains) setCutCoefficients(chain->get<ChainPositions::LowCut>(), cutDesign);
 }
 
-void SimpleEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings) {
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings,
+                                                  Chains chains) {
+    auto highCutDesign = designHighCut(chainSettings, getSampleRate());
 
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    for (auto *chain : chains)
+        setCutCoefficients(chain->get<ChainPositions::HighCut>(), highCutDesign);
 }
 
-void SimpleEQAudioProcessor::updateLowCutFilters(const ChainSettings &chainSettings) {
-    auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+void SimpleEQAudioProcessor::updateFilters(Stages stages, Stages sideStages) {
+    updateSvfFilters(stages, sideStages);
+    if (numWideChains > 0) updateWideFilters(stages);
+
+    auto *leftChain = &leftChains[activeChain];
+    auto *rightChain = &rightChains[activeChain];
+    auto chainSettings = parameters.getChainSettings();
+
+    if (parameters.getStereoMode() != StereoMode::MidSide) {
+        // the side's settings are only used in mid/side
+        if (stages.peak) updatePeakFilter(chainSettings, {leftChain, rightChain});
+        if (stages.lowCut) updateLowCutFilters(chainSettings, {leftChain, rightChain});
+        if (stages.highCut) updateHighCutFilters(chainSettings, {leftChain, rightChain});
+        return;
+    }
+
+    if (stages.peak) updatePeakFilter(chainSettings, {leftChain});
+    if (stages.lowCut) updateLowCutFilters(chainSettings, {leftChain});
+    if (stages.highCut) updateHighCutFilters(chainSettings, {leftChain});
 
-    auto &leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
-    auto &rightLowCut = rightChain.get<ChainPositions::LowCut>();
-    updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
+    auto sideSettings = parameters.getSideChainSettings();
+    if (sideStages.peak) updatePeakFilter(sideSettings, {rightChain});
+    if (sideStages.lowCut) updateLowCutFilters(sideSettings, {rightChain});
+    if (sideStages.highCut) updateHighCutFilters(sideSettings, {rightChain});
 }
 
-void SimpleEQAudioProcessor::updateHighCutFilters(const ChainSettings &chainSettings) {
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
+void SimpleEQAudioProcessor::updateSvfFilters(Stages stages, Stages sideStages) {
+    auto sampleRate = getSampleRate();
+    auto chainSettings = parameters.getChainSettings();
+    auto sideSettings = chainSettings;
+    if (parameters.getStereoMode() == StereoMode::MidSide)
+        sideSettings = parameters.getSideChainSettings();
+    else
+        sideStages = stages;
+
+    auto update = [sampleRate](SvfChain &chain, const ChainSettings &settings, Stages changed) {
+        if (changed.peak) chain.setPeak(settings, sampleRate);
+        if (changed.lowCut) chain.setLowCut(settings, sampleRate);
+        if (changed.highCut) chain.setHighCut(settings, sampleRate);
+    };
+    update(svfChains[0], chainSettings, stages);
+    update(svfChains[1], sideSettings, sideStages);
+}
+
+void SimpleEQAudioProcessor::updateWideFilters(Stages stages) {
+    auto sampleRate = getSampleRate();
+    auto chainSettings = parameters.getChainSettings();
+
+    auto peakCoefficients = designPeak(chainSettings, sampleRate);
+    auto lowCutDesign = designLowCut(chainSettings, sampleRate);
+    auto highCutDesign = designHighCut(chainSettings, sampleRate);
 
-    auto &leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    updateCutFilter(leftHighCut, highCutCoefficients, chainSettings.highCutSlope);
-    auto &rightHighCut = rightChain.get<ChainPositions::HighCut>();
-    updateCutFilter(rightHighCut, highCutCoefficients, chainSettings.highCutSlope);
+    for (int i = 0; i < numWideChains; ++i) {
+        auto &chain = wideChains[i];
+        if (stages.peak) setCoefficients(chain.get<ChainPositions::Peak>(), peakCoefficients);
+        if (stages.lowCut) setCutCoefficients(chain.get<ChainPositions::LowCut>(), lowCutDesign);
+        if (stages.highCut)
+            setCutCoefficients(chain.get<ChainPositions::HighCut>(), highCutDesign);
+    }
 }
 
 void SimpleEQAudioProcessor::updateAllFilters() {
-    auto chainSettings = getChainSettings(apvts);
+    SIMPLEEQ_TRACE_SCOPE("updateAllFilters");
+
+    parameters.consumeAllChanges(appliedGenerations);
+    updateFilters({true, true, true}, {true, true, true});
+}
 
-    updatePeakFilter(chainSettings);
-    updateLowCutFilters(chainSettings);
-    updateHighCutFilters(chainSettings);
+void SimpleEQAudioProcessor::updateChangedFilters() {
+    Stages stages, sideStages;
+    stages.peak = parameters.consumeChanges<Param::PeakFreq, Param::PeakGain, Param::PeakQuality>(
+        appliedGenerations);
+    stages.lowCut =
+        parameters.consumeChanges<Param::LowCutFreq, Param::LowCutSlope>(appliedGenerations);
+    stages.highCut =
+        parameters.consumeChanges<Param::HighCutFreq, Param::HighCutSlope>(appliedGenerations);
+    sideStages.peak = parameters.consumeChanges<Param::SidePeakFreq, Param::SidePeakGain,
+                                                Param::SidePeakQuality>(appliedGenerations);
+    sideStages.lowCut = parameters.consumeChanges<Param::SideLowCutFreq, Param::SideLowCutSlope>(
+        appliedGenerations);
+    sideStages.highCut = parameters.consumeChanges<Param::SideHighCutFreq,
+                                                   Param::SideHighCutSlope>(appliedGenerations);
+
+    // switching to or from mid/side changes what the right chain runs on
+    if (parameters.consumeChanges<Param::StereoMode>(appliedGenerations))
+        stages = sideStages = {true, true, true};
+
+    if (!(stages.peak || stages.lowCut || stages.highCut || sideStages.peak ||
+          sideStages.lowCut || sideStages.highCut))
+        return;
+
+    SIMPLEEQ_TRACE_SCOPE("updateChangedFilters");
+    updateFilters(stages, sideStages);
 }
 
 //==============================================================================
@@ -8,70 +8,17 @@
 
 #pragma once
 
+#include "BiquadDesigner.h"
+#include "CoefficientSnapshot.h"
+#include "FilterChain.h"
+#include "LevelMeter.h"
+#include "ParallelChannelRenderer.h"
+#include "Parameters.h"
+#include "PathVerifier.h"
+#include "ProgramBank.h"
+#include "SvfFilter.h"
 #include <JuceHeader.h>
 
-enum Slope { Slope12, Slope24, Slope36, Slope48 };
-
-struct ChainSettings {
-    float peakFreq{0}, peakGainInDecibels{0}, peakQuality{1.f};
-    float lowCutFreq{0}, highCutFreq{0};
-    Slope lowCutSlope{Slope::Slope12}, highCutSlope{Slope::Slope12};
-};
-
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState &apvts);
-
-using Filter = juce::dsp::IIR::Filter<float>;
-
-using CutFilter =
-    juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>; // 4 filters for different slopes
-
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
-
-enum ChainPositions { LowCut, Peak, HighCut };
-
-using Coefficients = Filter::CoefficientsPtr;
-void updateCoefficients(Coefficients &old, const Coefficients &replacements);
-
-Coefficients makePeakFilter(const ChainSettings &chainSettings, double sampleRate);
-
-template <int Index, typename ChainType, typename CoefficientType>
-void update(ChainType &chain, const CoefficientType &coefficients) {
-    updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-    chain.template setBypassed<Index>(false);
-}
-template <typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType &cut, const CoefficientType &cutCoefficients, const Slope &slope) {
-    cut.template setBypassed<0>(true);
-    cut.template setBypassed<1>(true);
-    cut.template setBypassed<2>(true);
-    cut.template setBypassed<3>(true);
-    switch (slope) {
-    case Slope48:
-        update<3>(cut, cutCoefficients);
-    case Slope36:
-        update<2>(cut, cutCoefficients);
-    case Slope24:
-        update<1>(cut, cutCoefficients);
-    case Slope12:
-        update<0>(cut, cutCoefficients);
-        break;
-    }
-}
-
-inline auto makeLowCutFilter(const ChainSettings &chainSettings, double sampleRate) {
-    // 0: 12db/oct -> order: 2
-    // 1: 18db/oct -> order: 4 ...
-    return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(
-        chainSettings.lowCutFreq, sampleRate, 2 * (chainSettings.lowCutSlope + 1));
-}
-
-inline auto makeHighCutFilter(const ChainSettings &chainSettings, double sampleRate) {
-    // 0: 12db/oct -> order: 2
-    // 1: 18db/oct -> order: 4 ...
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(
-        chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1));
-}
-
 //==============================================================================
 /**
  */
@@ -118,14 +65,115 @@ class SimpleEQAudioProcessor : public juce::AudioProcessor {
     // apvts is a member.
     juce::AudioProcessorValueTreeState apvts{*this, nullptr, "Parameters", createParameterLayout()};
 
-  private:
-    MonoChain leftChain, rightChain;
+    // The coefficients the audio thread is applying, for the editor. Returns true if
+    // they have changed since the last call.
+    bool readCoefficientSnapshot(CoefficientSnapshot &snapshot) {
+        return coefficientSnapshots.read(snapshot);
+    }
 
-    void updatePeakFilter(const ChainSettings &chainSettings);
+    // The levels of the main bus before and after the EQ, only measured while
+    // enabled, i.e. while an editor is showing them.
+    void setMeteringEnabled(bool enabled) { meteringEnabled = enabled; }
+    LevelMeter &getInputMeter() { return inputMeter; }
+    LevelMeter &getOutputMeter() { return outputMeter; }
+
+#if SIMPLEEQ_VERIFY_FAST_PATHS
+    // for the accuracy harness, which runs the processor itself
+    PathVerifier &getPathVerifier() { return pathVerifier; }
+#endif
+
+    // Main buses wider than stereo run a chain with the main settings on each channel.
+    static constexpr int maxMainChannels = 128;
+    static_assert(maxMainChannels <= LevelMeter::maxChannels, "the meters must cover the bus");
+
+  private:
+    Parameters parameters{apvts};
+    ProgramBank programBank;
+
+    // What the audio thread touches on every block starts on a cache line of its own,
+    // so that instances running on neighbouring worker threads don't share lines.
+    //
+    // The left chains run on mid and the right ones on side in the mid/side modes.
+    // Two pairs of chains, so that a program switch can crossfade from the outgoing
+    // chains (which keep their filter state) to the incoming ones.
+    alignas(cacheLineSize) std::array<MonoChain, 2> leftChains;
+    std::array<MonoChain, 2> rightChains;
+    int activeChain{0};
+
+    // what the audio thread has applied so far
+    Parameters::Generations appliedGenerations{};
+    FilterTopology appliedTopology{FilterTopology::Biquad};
+    double preparedSampleRate{0}; // of the active pair's designs
+
+    // the same filters as the active pair for FilterTopology::Svf, kept up to date
+    // in either topology so that switching only has to clear their state
+    std::array<SvfChain, 2> svfChains;
+
+    // one per channel of a wide main bus, spread over the renderer's threads offline
+    std::unique_ptr<MonoChain[]> wideChains;
+    int numWideChains{0};
+
+    // One set of workers for every instance in the process, started by the first
+    // prepareToPlay() for an offline render. An instance that finds it busy renders
+    // on its own thread.
+    struct SharedRenderer {
+        ParallelChannelRenderer renderer;
+        juce::SpinLock lock; // held for start() and run(), only tried by run()
+    };
+    juce::SharedResourcePointer<SharedRenderer> sharedRenderer;
+
+    DynamicPeakGain dynamicPeakGain;
+    juce::AudioBuffer<float> peakGainBuffer;
+
+    juce::AudioBuffer<float> fadeBuffer;
+    juce::LinearSmoothedValue<float> programFade;
+
+    // written by the audio thread (and prepareToPlay), read by the editor
+    CoefficientSnapshotBuffer coefficientSnapshots;
+    LevelMeter inputMeter, outputMeter;
+
+    // written by the message thread, kept off the lines of the audio thread's state
+    alignas(cacheLineSize) std::atomic<int> currentProgram{0};
+    static constexpr const char *currentProgramID = "currentProgram"; // in the saved state
+    // the program to switch to, -1 for none or programBeingSet while setCurrentProgram()
+    // is still setting the program's parameters
+    std::atomic<int> pendingProgram{-1};
+    static constexpr int programBeingSet = -2;
+    std::atomic<bool> meteringEnabled{false};
+
+#if SIMPLEEQ_VERIFY_FAST_PATHS
+    PathVerifier pathVerifier;
+    void verifyBlock(const juce::AudioBuffer<float> &buffer, bool matchesReference);
+#endif
 
-    void updateLowCutFilters(const ChainSettings &chainSettings);
-    void updateHighCutFilters(const ChainSettings &chainSettings);
+    void setParameters(const ChainSettings &chainSettings);
+    // the program whose parameters are all in place, once, or -1 or programBeingSet
+    int takePendingProgram();
+    // Everything processBlock() does between the meters. Returns false for blocks
+    // that the static stereo chain doesn't reproduce: crossfaded, dynamically
+    // modulated or wide ones, and those in the middle of a program switch.
+    bool processFilters(juce::AudioBuffer<float> &buffer);
+    void beginProgramFade(int index, int numSamples, StereoMode stereoMode);
+    void processProgramFade(juce::AudioBuffer<float> &buffer, StereoMode stereoMode);
+    void processSvf(juce::AudioBuffer<float> &buffer, StereoMode stereoMode);
+    void processWide(juce::AudioBuffer<float> &buffer);
+
+    // designs the filters once for all the given chains, without allocating
+    using Chains = std::initializer_list<MonoChain *>;
+    void updatePeakFilter(const ChainSettings &chainSettings, Chains chains);
+    void updateLowCutFilters(const ChainSettings &chainSettings, Chains chains);
+    void updateHighCutFilters(const ChainSettings &chainSettings, Chains chains);
+
+    // which stages of the mid (or left and right) and the side chains to update
+    struct Stages {
+        bool peak, lowCut, highCut;
+    };
+    void updateFilters(Stages stages, Stages sideStages);
+    void updateSvfFilters(Stages stages, Stages sideStages);
+    void updateWideFilters(Stages stages);
     void updateAllFilters();
+    // only the filters whose parameters have changed since the last update
+    void updateChangedFilters();
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimpleEQAudioProcessor)
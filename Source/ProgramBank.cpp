@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    ProgramBank.cpp
+    Factory programs with their coefficients designed in the background.
+
+  ==============================================================================
+*/
+
+#include "ProgramBank.h"
+#include "TraceProfiler.h"
+
+struct ProgramBank::DesignJob : juce::ThreadPoolJob {
+    DesignJob(ProgramBank &b, double rate)
+        : juce::ThreadPoolJob("SimpleEQ program design"), bank(b), sampleRate(rate) {}
+
+    JobStatus runJob() override {
+        SIMPLEEQ_TRACE_SCOPE("ProgramBank::DesignJob");
+
+        for (int i = 0; i < numPrograms; ++i) {
+            if (shouldExit()) break;
+
+            auto &set = bank.sets[i];
+            set = std::make_unique<CoefficientSet>(
+                makeCoefficientSet(bank.programs[i].settings, sampleRate));
+            bank.published[i].store(set.get(), std::memory_order_release);
+        }
+        return jobHasFinished;
+    }
+
+    ProgramBank &bank;
+    double sampleRate;
+};
+
+//==============================================================================
+ProgramBank::ProgramBank() {
+    // name, peak freq, peak gain, peak quality, low cut, high cut, low cut slope, high cut slope
+    programs = {{
+        {"Default", {750.f, 0.f, 1.f, 20.f, 20000.f, Slope12, Slope12}},
+        {"Low Cut 80Hz", {750.f, 0.f, 1.f, 80.f, 20000.f, Slope24, Slope12}},
+        {"Vocal Presence", {3000.f, 4.f, 1.2f, 100.f, 20000.f, Slope24, Slope12}},
+        {"Telephone", {1500.f, 3.f, 0.7f, 400.f, 3400.f, Slope48, Slope48}},
+        {"Warm", {250.f, 3.f, 0.8f, 20.f, 9000.f, Slope12, Slope12}},
+        {"De-Mud", {350.f, -4.f, 1.4f, 40.f, 20000.f, Slope24, Slope12}},
+        {"Air", {12000.f, 4.f, 0.5f, 20.f, 20000.f, Slope12, Slope12}},
+        {"Kick Punch", {60.f, 5.f, 1.5f, 20.f, 12000.f, Slope12, Slope12}},
+    }};
+}
+
+ProgramBank::~ProgramBank() { cancelDesign(); }
+
+const juce::String &ProgramBank::getName(int index) const { return programs[index].name; }
+
+void ProgramBank::setName(int index, const juce::String &newName) {
+    programs[index].name = newName;
+}
+
+const ChainSettings &ProgramBank::getSettings(int index) const {
+    return programs[index].settings;
+}
+
+void ProgramBank::prepare(double sampleRate) {
+    if (sampleRate == preparedSampleRate) return;
+
+    cancelDesign();
+
+    for (auto &p : published) p.store(nullptr, std::memory_order_relaxed);
+    for (auto &s : sets) s.reset();
+
+    preparedSampleRate = sampleRate;
+    designJob = std::make_unique<DesignJob>(*this, sampleRate);
+    designPool->pool.addJob(designJob.get(), false);
+}
+
+const CoefficientSet *ProgramBank::getCoefficientSet(int index) const noexcept {
+    return published[index].load(std::memory_order_acquire);
+}
+
+void ProgramBank::cancelDesign() {
+    if (designJob != nullptr) {
+        designPool->pool.removeJob(designJob.get(), true, -1);
+        designJob.reset();
+    }
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+    Factory programs with their coefficients designed in the background.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FilterChain.h"
+#include <JuceHeader.h>
+
+class ProgramBank {
+  public:
+    ProgramBank();
+    ~ProgramBank();
+
+    static constexpr int numPrograms = 8;
+
+    const juce::String &getName(int index) const;
+    void setName(int index, const juce::String &newName);
+    const ChainSettings &getSettings(int index) const;
+
+    // Throws the designed sets away and designs them again for the new rate on
+    // the shared background thread. Must not be called while the audio thread
+    // may be reading the sets, i.e. only from prepareToPlay() and friends.
+    void prepare(double sampleRate);
+
+    // Lock-free, safe to call from the audio thread. Returns nullptr while the
+    // program is still being designed.
+    const CoefficientSet *getCoefficientSet(int index) const noexcept;
+
+  private:
+    struct Program {
+        juce::String name;
+        ChainSettings settings;
+    };
+    std::array<Program, numPrograms> programs;
+
+    std::array<std::unique_ptr<CoefficientSet>, numPrograms> sets;
+    std::array<std::atomic<const CoefficientSet *>, numPrograms> published{};
+    double preparedSampleRate{0};
+
+    // one design thread shared by every instance in the process
+    struct DesignPool {
+        juce::ThreadPool pool{1};
+    };
+    juce::SharedResourcePointer<DesignPool> designPool;
+
+    struct DesignJob;
+    std::unique_ptr<DesignJob> designJob;
+
+    void cancelDesign();
+
+    JUCE_DECLARE_NON_COPYABLE(ProgramBank)
+};
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    SharedImageCache.cpp
+    Pre-rendered editor images, shared by every open editor in the process.
+
+  ==============================================================================
+*/
+
+#include "SharedImageCache.h"
+
+juce::Image SharedImageCache::get(const juce::String &name, int width, int height, float scale,
+                                  const Renderer &render) {
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    juce::String key;
+    key << name << "_" << width << "x" << height << "@" << scale;
+
+    auto found = images.find(key);
+    if (found != images.end()) return found->second;
+
+    if (images.size() >= maxImages) images.clear();
+
+    auto physicalWidth = juce::jmax(1, juce::roundToInt(width * scale));
+    auto physicalHeight = juce::jmax(1, juce::roundToInt(height * scale));
+    juce::Image image(juce::Image::PixelFormat::ARGB, physicalWidth, physicalHeight, true);
+    {
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(physicalWidth / float(juce::jmax(1, width)),
+                                                    physicalHeight / float(juce::jmax(1, height))));
+        render(g);
+    }
+
+    images.emplace(key, image);
+    return image;
+}
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+
+    SharedImageCache.h
+    Pre-rendered editor images, shared by every open editor in the process.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Images are keyed by name, size and display scale, and rendered once at the
+// physical resolution. Only to be used from the message thread.
+class SharedImageCache {
+  public:
+    using Renderer = std::function<void(juce::Graphics &)>;
+
+    // Returns the image for width x height logical pixels at the given scale,
+    // calling render (with the scale already applied) if it isn't cached yet.
+    juce::Image get(const juce::String &name, int width, int height, float scale,
+                    const Renderer &render);
+
+  private:
+    // plenty for a handful of editor sizes, it just starts over past that
+    static constexpr size_t maxImages = 256;
+
+    std::map<juce::String, juce::Image> images;
+};
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    SimpleEQCore.cpp
+    C API of the headless EQ, for embedding without a plugin host.
+
+  ==============================================================================
+*/
+
+#include "SimpleEQCore.h"
+#include "BiquadDesigner.h"
+#include "FilterChain.h"
+
+// a chain's coefficients as values, designed without allocating
+struct Design {
+    BiquadCoefficients peak;
+    CutDesign lowCut, highCut;
+};
+
+static Design makeDesign(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    return {designPeak(chainSettings, sampleRate), designLowCut(chainSettings, sampleRate),
+            designHighCut(chainSettings, sampleRate)};
+}
+
+// only copies, once the chain is primed
+static void applyDesign(MonoChain &chain, const Design &design) {
+    setCoefficients(chain.get<ChainPositions::Peak>(), design.peak);
+    setCutCoefficients(chain.get<ChainPositions::LowCut>(), design.lowCut);
+    setCutCoefficients(chain.get<ChainPositions::HighCut>(), design.highCut);
+}
+
+struct SimpleEQCore {
+    double sampleRate;
+    int maxBlockSize;
+    int numChannels;
+    std::unique_ptr<MonoChain[]> chains;
+
+    // settings designed by simpleeq_set_settings(), waiting for the processing thread
+    juce::SpinLock stagingLock;
+    Design staged;
+    bool hasStaged{false};
+
+    void applyStaged() noexcept {
+        // never blocks processing, a busy lock just delays the update to the next call
+        juce::SpinLock::ScopedTryLockType lock(stagingLock);
+        if (!lock.isLocked() || !hasStaged) return;
+
+        for (int i = 0; i < numChannels; ++i) applyDesign(chains[i], staged);
+        hasStaged = false;
+    }
+};
+
+static ChainSettings toChainSettings(const SimpleEQSettings &settings) {
+    ChainSettings chainSettings;
+    chainSettings.peakFreq = settings.peakFreq;
+    chainSettings.peakGainInDecibels = settings.peakGainInDecibels;
+    chainSettings.peakQuality = settings.peakQuality;
+    chainSettings.lowCutFreq = settings.lowCutFreq;
+    chainSettings.highCutFreq = settings.highCutFreq;
+    chainSettings.lowCutSlope = static_cast<Slope>(juce::jlimit(0, 3, settings.lowCutSlope));
+    chainSettings.highCutSlope = static_cast<Slope>(juce::jlimit(0, 3, settings.highCutSlope));
+    return chainSettings;
+}
+
+void simpleeq_get_default_settings(SimpleEQSettings *settings) {
+    if (settings == nullptr) return;
+
+    // the defaults of the plugin's parameters
+    settings->peakFreq = 750.f;
+    settings->peakGainInDecibels = 0.f;
+    settings->peakQuality = 1.f;
+    settings->lowCutFreq = 20.f;
+    settings->highCutFreq = 20000.f;
+    settings->lowCutSlope = 0;
+    settings->highCutSlope = 0;
+}
+
+SimpleEQCore *simpleeq_create(double sampleRate, int maxBlockSize, int numChannels) {
+    if (sampleRate <= 0 || maxBlockSize <= 0 || numChannels <= 0) return nullptr;
+
+    auto eq = std::make_unique<SimpleEQCore>();
+    eq->sampleRate = sampleRate;
+    eq->maxBlockSize = maxBlockSize;
+    eq->numChannels = numChannels;
+    eq->chains = std::make_unique<MonoChain[]>((size_t)numChannels);
+
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = (juce::uint32)maxBlockSize;
+    spec.numChannels = 1;
+    spec.sampleRate = sampleRate;
+
+    SimpleEQSettings settings;
+    simpleeq_get_default_settings(&settings);
+    auto chainSettings = toChainSettings(settings);
+
+    // Give every stage its second order coefficients once, so that later updates
+    // only copy values into them instead of reallocating. prepare() sized the filters'
+    // state for the first order coefficients they start with, reset() sizes it for
+    // the second order ones so that the first process call doesn't.
+    auto steepestSet = makePrimingSet(chainSettings, sampleRate);
+    auto defaultDesign = makeDesign(chainSettings, sampleRate);
+
+    for (int i = 0; i < numChannels; ++i) {
+        auto &chain = eq->chains[i];
+        chain.prepare(spec);
+        applyCoefficientSet(chain, steepestSet);
+        applyDesign(chain, defaultDesign);
+        chain.reset();
+    }
+
+    return eq.release();
+}
+
+void simpleeq_destroy(SimpleEQCore *eq) { delete eq; }
+
+void simpleeq_set_settings(SimpleEQCore *eq, const SimpleEQSettings *settings) {
+    if (eq == nullptr || settings == nullptr) return;
+
+    auto designed = makeDesign(toChainSettings(*settings), eq->sampleRate);
+
+    const juce::SpinLock::ScopedLockType lock(eq->stagingLock);
+    eq->staged = designed;
+    eq->hasStaged = true;
+}
+
+void simpleeq_reset(SimpleEQCore *eq) {
+    if (eq == nullptr) return;
+
+    for (int i = 0; i < eq->numChannels; ++i) eq->chains[i].reset();
+}
+
+void simpleeq_process_planar(SimpleEQCore *eq, float *const *channels, int numChannels,
+                             int numSamples) {
+    if (eq == nullptr || channels == nullptr || numSamples <= 0) return;
+    jassert(numChannels <= eq->numChannels && numSamples <= eq->maxBlockSize);
+
+    juce::ScopedNoDenormals noDenormals;
+    eq->applyStaged();
+
+    juce::dsp::AudioBlock<float> block(channels, (size_t)juce::jmin(numChannels, eq->numChannels),
+                                       (size_t)numSamples);
+    for (size_t i = 0; i < block.getNumChannels(); ++i) {
+        auto channelBlock = block.getSingleChannelBlock(i);
+        juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+        eq->chains[i].process(context);
+    }
+}
+
+void simpleeq_process_interleaved(SimpleEQCore *eq, float *samples, int numChannels,
+                                  int numFrames) {
+    if (eq == nullptr || samples == nullptr || numFrames <= 0) return;
+    jassert(numChannels <= eq->numChannels && numFrames <= eq->maxBlockSize);
+
+    juce::ScopedNoDenormals noDenormals;
+    eq->applyStaged();
+
+    // sample by sample along each channel's stride, so that nothing is deinterleaved
+    for (int channel = 0; channel < juce::jmin(numChannels, eq->numChannels); ++channel) {
+        auto &chain = eq->chains[channel];
+        auto *sample = samples + channel;
+        for (int i = 0; i < numFrames; ++i, sample += numChannels)
+            *sample = processSample(chain, *sample);
+    }
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    SimpleEQCore.h
+    C API of the headless EQ, for embedding without a plugin host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SimpleEQCore SimpleEQCore;
+
+typedef struct SimpleEQSettings {
+    float peakFreq, peakGainInDecibels, peakQuality;
+    float lowCutFreq, highCutFreq;
+    int lowCutSlope, highCutSlope; /* 0: 12 dB/Oct, 1: 24, 2: 36, 3: 48 */
+} SimpleEQSettings;
+
+/* The plugin's default settings, i.e. a flat response. */
+void simpleeq_get_default_settings(SimpleEQSettings *settings);
+
+/* Allocates everything the EQ needs, nothing is allocated after this.
+   Returns NULL if the arguments are invalid. */
+SimpleEQCore *simpleeq_create(double sampleRate, int maxBlockSize, int numChannels);
+void simpleeq_destroy(SimpleEQCore *eq);
+
+/* Safe to call from any thread while another thread is processing. The filters are
+   designed on the calling thread, without allocating, and picked up at the start of
+   a later process call. */
+void simpleeq_set_settings(SimpleEQCore *eq, const SimpleEQSettings *settings);
+
+/* Clears the filters' state. Must not be called concurrently with processing. */
+void simpleeq_reset(SimpleEQCore *eq);
+
+/* Process the caller's buffers in place, without copying or allocating.
+   numChannels must not exceed the number the EQ was created with, and
+   numSamples / numFrames must not exceed its maxBlockSize. */
+void simpleeq_process_planar(SimpleEQCore *eq, float *const *channels, int numChannels,
+                             int numSamples);
+void simpleeq_process_interleaved(SimpleEQCore *eq, float *samples, int numChannels,
+                                  int numFrames);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    SvfFilter.cpp
+    Topology-preserving state variable filters, for coefficients that change
+    every sample.
+
+  ==============================================================================
+*/
+
+#include "SvfFilter.h"
+
+void SvfFilter::setFrequency(double sampleRate, float freq) noexcept {
+    // prewarped like the bilinear transform of the biquads, kept below nyquist
+    auto clamped = juce::jmin((double)freq, sampleRate * 0.49);
+    g = (float)std::tan(juce::MathConstants<double>::pi * clamped / sampleRate);
+}
+
+void SvfFilter::setLowPass(double sampleRate, float freq, float q) noexcept {
+    setFrequency(sampleRate, freq);
+    quality = q;
+    k = 1.f / q;
+    updateCoefficients();
+    m0 = 0.f;
+    m1 = 0.f;
+    m2 = 1.f;
+}
+
+void SvfFilter::setHighPass(double sampleRate, float freq, float q) noexcept {
+    setFrequency(sampleRate, freq);
+    quality = q;
+    k = 1.f / q;
+    updateCoefficients();
+    m0 = 1.f;
+    m1 = -k;
+    m2 = -1.f;
+}
+
+void SvfFilter::setBell(double sampleRate, float freq, float q, float gain) noexcept {
+    setFrequency(sampleRate, freq);
+    quality = q;
+    m0 = 1.f;
+    m2 = 0.f;
+    setBellGain(gain);
+}
+
+//==============================================================================
+void SvfChain::setPeak(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    // the same response as makePeakFilter(), which takes the linear gain too
+    peakGain = juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels);
+    peak.setBell(sampleRate, chainSettings.peakFreq, chainSettings.peakQuality, peakGain);
+}
+
+void SvfChain::setLowCut(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    numLowCutStages = chainSettings.lowCutSlope + 1;
+    for (int i = 0; i < numLowCutStages; ++i)
+        lowCut[i].setHighPass(sampleRate, chainSettings.lowCutFreq,
+                              (float)getButterworthQuality(2 * numLowCutStages, i));
+}
+
+void SvfChain::setHighCut(const ChainSettings &chainSettings, double sampleRate) noexcept {
+    numHighCutStages = chainSettings.highCutSlope + 1;
+    for (int i = 0; i < numHighCutStages; ++i)
+        highCut[i].setLowPass(sampleRate, chainSettings.highCutFreq,
+                              (float)getButterworthQuality(2 * numHighCutStages, i));
+}
+
+void SvfChain::reset() noexcept {
+    for (auto &filter : lowCut) filter.reset();
+    for (auto &filter : highCut) filter.reset();
+    peak.reset();
+}
+
+void SvfChain::process(float *samples, int numSamples,
+                       const float *peakGainMultipliers) noexcept {
+    // back to the static gain after modulation has stopped
+    if (peakGainMultipliers == nullptr && peakModulated) peak.setBellGain(peakGain);
+    peakModulated = peakGainMultipliers != nullptr;
+
+    for (int i = 0; i < numSamples; ++i) {
+        auto sample = samples[i];
+        for (int stage = 0; stage < numLowCutStages; ++stage)
+            sample = lowCut[stage].processSample(sample);
+
+        if (peakGainMultipliers != nullptr) peak.setBellGain(peakGain * peakGainMultipliers[i]);
+        sample = peak.processSample(sample);
+
+        for (int stage = 0; stage < numHighCutStages; ++stage)
+            sample = highCut[stage].processSample(sample);
+        samples[i] = sample;
+    }
+}
+
+//==============================================================================
+void DynamicPeakGain::prepare(double newSampleRate) noexcept {
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void DynamicPeakGain::reset() noexcept {
+    envelope = 0.f;
+    multiplier = 1.f;
+    step = 0.f;
+    samplesToControl = 0;
+}
+
+void DynamicPeakGain::setParameters(float rangeInDecibels, float thresholdInDecibels,
+                                    float attackMs, float releaseMs) noexcept {
+    range = rangeInDecibels;
+    threshold = thresholdInDecibels;
+    attack = (float)std::exp(-1000.0 / (attackMs * sampleRate));
+    release = (float)std::exp(-1000.0 / (releaseMs * sampleRate));
+}
+
+void DynamicPeakGain::process(float *levels, int numSamples) noexcept {
+    for (int i = 0; i < numSamples; ++i) {
+        auto level = levels[i];
+        auto coefficient = level > envelope ? attack : release;
+        envelope = level + coefficient * (envelope - level);
+
+        if (--samplesToControl <= 0) {
+            // the logs and powers only once per interval
+            auto over = juce::jmax(0.f, juce::Decibels::gainToDecibels(envelope) - threshold);
+            auto gainInDecibels = range > 0 ? juce::jmin(over, range) : juce::jmax(-over, range);
+            auto target = juce::Decibels::decibelsToGain(gainInDecibels);
+            step = (target - multiplier) / controlInterval;
+            samplesToControl = controlInterval;
+        }
+
+        multiplier += step;
+        levels[i] = multiplier;
+    }
+}
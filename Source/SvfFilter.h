@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    SvfFilter.h
+    Topology-preserving state variable filters, for coefficients that change
+    every sample.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "FilterChain.h"
+#include <JuceHeader.h>
+
+// A trapezoidal (TPT) state variable filter after Zavalishin and Simper. Its state
+// stays valid when the coefficients change, so unlike the direct form biquads they
+// can be changed every sample without clicks or blowing up.
+class SvfFilter {
+  public:
+    void setLowPass(double sampleRate, float freq, float quality) noexcept;
+    void setHighPass(double sampleRate, float freq, float quality) noexcept;
+    // gain is the linear amplitude at the centre frequency
+    void setBell(double sampleRate, float freq, float quality, float gain) noexcept;
+
+    // The bell's gain with the frequency and quality of the last setBell(), at
+    // the price of a square root, two divisions and a few multiplies.
+    void setBellGain(float gain) noexcept {
+        auto a = std::sqrt(gain);
+        k = 1.f / (quality * a);
+        updateCoefficients();
+        m1 = k * (gain - 1.f); // k (A^2 - 1)
+    }
+
+    void reset() noexcept { ic1eq = ic2eq = 0.f; }
+
+    float processSample(float x) noexcept {
+        auto v3 = x - ic2eq;
+        auto v1 = a1 * ic1eq + a2 * v3;
+        auto v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        ic1eq = 2.f * v1 - ic1eq;
+        ic2eq = 2.f * v2 - ic2eq;
+        return m0 * x + m1 * v1 + m2 * v2;
+    }
+
+  private:
+    float g{0}, k{1}, quality{1};
+    float a1{0}, a2{0}, a3{0};
+    float m0{1}, m1{0}, m2{0};
+    float ic1eq{0}, ic2eq{0};
+
+    void setFrequency(double sampleRate, float freq) noexcept;
+    void updateCoefficients() noexcept {
+        a1 = 1.f / (1.f + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+};
+
+// The same stages as MonoChain, with the same responses while nothing is modulated.
+class SvfChain {
+  public:
+    void setPeak(const ChainSettings &chainSettings, double sampleRate) noexcept;
+    void setLowCut(const ChainSettings &chainSettings, double sampleRate) noexcept;
+    void setHighCut(const ChainSettings &chainSettings, double sampleRate) noexcept;
+
+    void reset() noexcept;
+
+    // In place. With peakGainMultipliers, the peak's linear gain is multiplied by
+    // the sample's multiplier.
+    void process(float *samples, int numSamples, const float *peakGainMultipliers) noexcept;
+
+  private:
+    std::array<SvfFilter, 4> lowCut, highCut;
+    int numLowCutStages{1}, numHighCutStages{1};
+
+    SvfFilter peak;
+    float peakGain{1};
+    bool peakModulated{false};
+};
+
+// Turns the level of a detector signal into a multiplier of the peak's gain:
+// above the threshold the gain moves by as many dB as the level, up to the range.
+// The gain is computed at a control rate and ramped in between.
+class DynamicPeakGain {
+  public:
+    void prepare(double sampleRate) noexcept;
+    void reset() noexcept;
+
+    void setParameters(float rangeInDecibels, float thresholdInDecibels, float attackMs,
+                       float releaseMs) noexcept;
+
+    // levels in (non-negative), multipliers out
+    void process(float *levels, int numSamples) noexcept;
+
+  private:
+    static constexpr int controlInterval = 16;
+
+    double sampleRate{44100};
+    float range{0}, threshold{0};
+    float attack{0}, release{0};
+
+    float envelope{0};
+    float multiplier{1}, step{0};
+    int samplesToControl{0};
+};
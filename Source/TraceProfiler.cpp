@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    TraceProfiler.cpp
+    Opt-in scoped trace events, written out as a Chrome/Perfetto trace file.
+
+  ==============================================================================
+*/
+
+#include "TraceProfiler.h"
+
+#if SIMPLEEQ_ENABLE_TRACING
+
+namespace {
+constexpr int maxThreads = 32;
+constexpr juce::uint64 eventsPerThread = 8192; // a power of two
+
+struct Event {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<juce::int64> start{0}, end{0};
+};
+
+enum BufferState { unclaimed, claiming, claimed };
+
+struct ThreadBuffer {
+    std::atomic<int> state{unclaimed};
+    std::atomic<juce::Thread::ThreadID> threadId{nullptr};
+    // bumped whenever another thread takes the buffer over, for the reader
+    std::atomic<juce::uint32> generation{0};
+    std::atomic<juce::int64> lastTicks{0}; // of the latest event, 0 once released
+    std::atomic<bool> registered{false};   // kept however long it is idle
+
+    std::atomic<bool> isMessageThread{false};
+    char threadName[64]{}; // from registerThread(), empty for the host's threads
+    std::atomic<juce::uint64> firstEvent{0}; // the ones before are the previous thread's
+    std::atomic<juce::uint64> head{0}; // number of events written so far
+    std::array<Event, eventsPerThread> events;
+};
+
+std::array<ThreadBuffer, maxThreads> threadBuffers;
+const juce::int64 startTicks = juce::Time::getHighResolutionTicks();
+
+// Threads are told apart by their IDs rather than thread_local pointers, which in
+// a plugin loaded at runtime may allocate on the first access from a thread.
+ThreadBuffer *findThreadBuffer(juce::Thread::ThreadID threadId) noexcept {
+    for (auto &buffer : threadBuffers)
+        if (buffer.state.load(std::memory_order_acquire) == claimed &&
+            buffer.threadId.load(std::memory_order_relaxed) == threadId)
+            return &buffer;
+    return nullptr;
+}
+
+ThreadBuffer *claimThreadBuffer(juce::Thread::ThreadID threadId, juce::int64 now,
+                                const char *threadName) noexcept {
+    auto take = [threadId, now, threadName](ThreadBuffer &buffer) {
+        buffer.generation.fetch_add(1, std::memory_order_acq_rel);
+        buffer.threadId.store(threadId, std::memory_order_relaxed);
+        buffer.isMessageThread.store(juce::MessageManager::existsAndIsCurrentThread(),
+                                     std::memory_order_relaxed);
+        // not juce::Thread::getCurrentThread()'s name, which allocates on a new thread
+        juce::CharPointer_UTF8(buffer.threadName)
+            .writeWithDestByteLimit(juce::CharPointer_UTF8(threadName != nullptr ? threadName : ""),
+                                    sizeof(buffer.threadName));
+        buffer.firstEvent.store(buffer.head.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+        buffer.lastTicks.store(now, std::memory_order_relaxed);
+        buffer.registered.store(threadName != nullptr, std::memory_order_relaxed);
+        buffer.state.store(claimed, std::memory_order_release);
+        return &buffer;
+    };
+
+    for (auto &buffer : threadBuffers) {
+        auto expected = (int)unclaimed;
+        if (buffer.state.compare_exchange_strong(expected, claiming)) return take(buffer);
+    }
+
+    // Hosts start and stop audio and render threads as they please. The buffers of
+    // threads that have been released, or of the host's that have gone quiet for a
+    // second, go to new ones.
+    auto idleTicks = juce::Time::getHighResolutionTicksPerSecond();
+    for (auto &buffer : threadBuffers) {
+        auto lastTicks = buffer.lastTicks.load(std::memory_order_relaxed);
+        auto released = lastTicks == 0;
+        if (!released && (buffer.registered.load(std::memory_order_relaxed) ||
+                          now - lastTicks < idleTicks))
+            continue;
+        auto expected = (int)claimed;
+        if (buffer.state.compare_exchange_strong(expected, claiming)) return take(buffer);
+    }
+    return nullptr;
+}
+} // namespace
+
+void TraceProfiler::record(const char *name, juce::int64 beginTicks,
+                           juce::int64 endTicks) noexcept {
+    auto threadId = juce::Thread::getCurrentThreadId();
+    auto *buffer = findThreadBuffer(threadId);
+    if (buffer == nullptr) buffer = claimThreadBuffer(threadId, endTicks, nullptr);
+    if (buffer == nullptr) return;
+
+    auto head = buffer->head.load(std::memory_order_relaxed);
+    auto &event = buffer->events[head & (eventsPerThread - 1)];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(beginTicks, std::memory_order_relaxed);
+    event.end.store(endTicks, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+    buffer->lastTicks.store(endTicks, std::memory_order_relaxed);
+}
+
+void TraceProfiler::registerThread(const char *name) noexcept {
+    // a buffer of its own from the start, even if it has recorded before
+    releaseThread();
+    claimThreadBuffer(juce::Thread::getCurrentThreadId(), juce::Time::getHighResolutionTicks(),
+                      name);
+}
+
+void TraceProfiler::releaseThread() noexcept {
+    if (auto *buffer = findThreadBuffer(juce::Thread::getCurrentThreadId())) {
+        // still written out until another thread takes it over
+        buffer->threadId.store(nullptr, std::memory_order_relaxed);
+        buffer->lastTicks.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TraceProfiler::writeTo(const juce::File &file) {
+    auto microsecondsPerTick = 1.0e6 / double(juce::Time::getHighResolutionTicksPerSecond());
+    auto toMicroseconds = [microsecondsPerTick](juce::int64 ticks) {
+        return juce::String(double(ticks - startTicks) * microsecondsPerTick, 3);
+    };
+
+    juce::MemoryOutputStream json;
+    json << "{\"traceEvents\":[\n";
+
+    auto separator = "";
+    for (int tid = 0; tid < maxThreads; ++tid) {
+        auto &buffer = threadBuffers[tid];
+        auto generation = buffer.generation.load(std::memory_order_acquire);
+        if (buffer.state.load(std::memory_order_acquire) != claimed) continue;
+
+        // written to the file only if no other thread has taken the buffer over since
+        juce::MemoryOutputStream threadJson;
+        auto threadSeparator = separator;
+
+        auto threadName = buffer.isMessageThread.load(std::memory_order_relaxed)
+                              ? juce::String("Message thread")
+                          : buffer.threadName[0] != 0
+                              ? juce::String::fromUTF8(buffer.threadName)
+                              : "Thread " + juce::String(tid);
+        threadJson << threadSeparator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                   << tid << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+        threadSeparator = ",\n";
+
+        auto head = buffer.head.load(std::memory_order_acquire);
+        auto first = juce::jmax(buffer.firstEvent.load(std::memory_order_relaxed),
+                                head > eventsPerThread ? head - eventsPerThread : juce::uint64(0));
+
+        for (auto i = first; i < head; ++i) {
+            auto &event = buffer.events[i & (eventsPerThread - 1)];
+            auto *name = event.name.load(std::memory_order_relaxed);
+            auto start = event.start.load(std::memory_order_relaxed);
+            auto end = event.end.load(std::memory_order_relaxed);
+
+            // skip the events the writer has lapped while we were reading them
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer.head.load(std::memory_order_relaxed) >= i + eventsPerThread) continue;
+
+            threadJson << threadSeparator << "{\"name\":\"" << name
+                       << "\",\"cat\":\"SimpleEQ\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                       << ",\"ts\":" << toMicroseconds(start) << ",\"dur\":"
+                       << juce::String(double(end - start) * microsecondsPerTick, 3) << "}";
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (buffer.generation.load(std::memory_order_relaxed) != generation) continue;
+        json << threadJson.toString();
+        separator = ",\n";
+    }
+
+    json << "\n]}\n";
+    return file.replaceWithData(json.getData(), json.getDataSize());
+}
+
+juce::File TraceProfiler::getDefaultFile() {
+    return juce::File::getSpecialLocation(juce::File::tempDirectory)
+        .getChildFile("SimpleEQ-trace.json");
+}
+
+#endif
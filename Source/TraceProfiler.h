@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    TraceProfiler.h
+    Opt-in scoped trace events, written out as a Chrome/Perfetto trace file.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Build with SIMPLEEQ_ENABLE_TRACING=1 to record every SIMPLEEQ_TRACE_SCOPE.
+// Otherwise the scopes compile to nothing.
+#ifndef SIMPLEEQ_ENABLE_TRACING
+#define SIMPLEEQ_ENABLE_TRACING 0
+#endif
+
+#if SIMPLEEQ_ENABLE_TRACING
+
+// Each thread records into its own preallocated ring buffer, so recording never
+// locks or allocates and is safe on the audio thread. The buffers are shared by
+// every instance in the process and keep the latest events of up to 32 threads at
+// a time. Released threads, and the host's threads that have stopped recording for
+// a second, make room for new ones.
+class TraceProfiler {
+  public:
+    struct Scope {
+        explicit Scope(const char *eventName) noexcept
+            : name(eventName), start(juce::Time::getHighResolutionTicks()) {}
+        ~Scope() noexcept { record(name, start, juce::Time::getHighResolutionTicks()); }
+
+        const char *name; // must be a string literal
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    static void record(const char *name, juce::int64 beginTicks, juce::int64 endTicks) noexcept;
+
+    // For threads of our own: registerThread() names the calling thread's buffer in
+    // the trace, releaseThread() hands it to the next new thread before exiting.
+    // Other threads get a buffer when they first record.
+    static void registerThread(const char *name) noexcept; // name must be a string literal
+    static void releaseThread() noexcept;
+
+    // Writes the recorded events as trace event JSON, which chrome://tracing and
+    // ui.perfetto.dev can open. Not to be called from the audio thread.
+    static bool writeTo(const juce::File &file);
+    static juce::File getDefaultFile();
+};
+
+#define SIMPLEEQ_TRACE_SCOPE(name) TraceProfiler::Scope JUCE_JOIN_MACRO(traceScope, __LINE__)(name)
+#define SIMPLEEQ_TRACE_REGISTER_THREAD(name) TraceProfiler::registerThread(name)
+#define SIMPLEEQ_TRACE_RELEASE_THREAD() TraceProfiler::releaseThread()
+
+#else
+
+#define SIMPLEEQ_TRACE_SCOPE(name)
+#define SIMPLEEQ_TRACE_REGISTER_THREAD(name)
+#define SIMPLEEQ_TRACE_RELEASE_THREAD()
+
+#endif
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Times SimpleEQ instances from construction to their first processed block,
+    the way a host loads a project.
+
+  ==============================================================================
+*/
+
+#include "../../Source/PluginProcessor.h"
+#include "../../Tools/ToolSupport.h"
+#include <JuceHeader.h>
+#include <iostream>
+
+namespace {
+struct Options {
+    int numInstances{256};
+    int blockSize{512};
+    double sampleRate{48000};
+    bool openEditors{false};
+};
+
+// What a host does between loading an instance and hearing it, each step timed
+// on its own, in ms.
+enum Phase { Construct, Prepare, FirstBlock, Reprepare, NewRate, OpenEditor, numPhases };
+constexpr const char *phaseNames[] = {"construct",     "prepareToPlay", "first block",
+                                      "prepare again", "new rate",      "open editor"};
+
+struct Instance {
+    std::unique_ptr<SimpleEQAudioProcessor> processor;
+    std::unique_ptr<juce::AudioProcessorEditor> editor;
+    std::array<double, numPhases> times{};
+};
+
+void load(Instance &instance, const Options &options, juce::AudioBuffer<float> &buffer) {
+    juce::MidiBuffer midi;
+    auto &times = instance.times;
+
+    times[Construct] = timeMilliseconds(
+        [&] { instance.processor = std::make_unique<SimpleEQAudioProcessor>(); });
+    auto &processor = *instance.processor;
+
+    times[Prepare] = timeMilliseconds([&] {
+        processor.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+        processor.prepareToPlay(options.sampleRate, options.blockSize);
+    });
+    times[FirstBlock] = timeMilliseconds([&] { processor.processBlock(buffer, midi); });
+    // hosts prepare again when the transport starts, at the same rate
+    times[Reprepare] = timeMilliseconds(
+        [&] { processor.prepareToPlay(options.sampleRate, options.blockSize); });
+    // and at another, which has to design everything again, for comparison
+    auto newRate = options.sampleRate == 44100 ? 48000.0 : 44100.0;
+    times[NewRate] = timeMilliseconds([&] {
+        processor.setRateAndBufferSizeDetails(newRate, options.blockSize);
+        processor.prepareToPlay(newRate, options.blockSize);
+    });
+
+    if (options.openEditors) {
+        // until the editor's first paint, which is when its images are rendered
+        times[OpenEditor] = timeMilliseconds([&] {
+            instance.editor.reset(processor.createEditorIfNeeded());
+            if (instance.editor != nullptr)
+                instance.editor->createComponentSnapshot(instance.editor->getLocalBounds());
+        });
+    }
+}
+
+void printRow(const juce::String &name, const Percentiles &percentiles) {
+    auto column = [](double value) { return juce::String(value, 3).paddedLeft(' ', 10); };
+    std::cout << name.paddedRight(' ', 16) << column(percentiles.p50) << column(percentiles.p90)
+              << column(percentiles.p99) << column(percentiles.max) << std::endl;
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::cout << "SimpleEQStartupBenchmark [--instances=N] [--block=N] [--rate=N] [--editor]\n"
+                     "Loads N instances one after another, as a host loads a project, and "
+                     "times each of them up to its first block."
+                  << std::endl;
+        return 0;
+    }
+
+    Options options;
+    options.numInstances = getIntOption(args, "--instances", options.numInstances);
+    options.blockSize = getIntOption(args, "--block", options.blockSize);
+    options.sampleRate = getDoubleOption(args, "--rate", options.sampleRate);
+    options.openEditors = args.containsOption("--editor");
+
+    juce::AudioBuffer<float> buffer(2, options.blockSize);
+    juce::Random random(1);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < options.blockSize; ++i)
+            buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+    std::vector<Instance> instances((size_t)options.numInstances);
+    auto loadTime = timeMilliseconds([&] {
+        for (auto &instance : instances) load(instance, options, buffer);
+    });
+
+    // the first instance also builds what the process shares between instances
+    auto &first = instances.front().times;
+    std::cout << options.numInstances << " instances, " << options.blockSize << " samples at "
+              << options.sampleRate << " Hz\n"
+              << "first instance to its first block: "
+              << juce::String(first[Construct] + first[Prepare] + first[FirstBlock], 3)
+              << " ms\n"
+              << "all instances to their first blocks: " << juce::String(loadTime, 1) << " ms, "
+              << juce::String(loadTime / options.numInstances, 3) << " ms per instance\n"
+              << std::endl;
+
+    std::cout << "ms                     p50       p90       p99       max" << std::endl;
+    for (int phase = 0; phase < numPhases; ++phase) {
+        if (phase == OpenEditor && !options.openEditors) continue;
+
+        std::vector<double> times;
+        for (auto &instance : instances) times.push_back(instance.times[(size_t)phase]);
+        printRow(phaseNames[phase], Percentiles(times));
+    }
+    std::vector<double> totals;
+    for (auto &instance : instances)
+        totals.push_back(instance.times[Construct] + instance.times[Prepare] +
+                         instance.times[FirstBlock]);
+    printRow("to first block", Percentiles(totals));
+
+    // editors go before their processors
+    for (auto &instance : instances) instance.editor = nullptr;
+    return 0;
+}
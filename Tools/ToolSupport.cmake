@@ -0,0 +1,107 @@
+# What the CMakeLists.txt of the console tools and of the core library have in
+# common, included by each of them after Reprojucer.
+
+
+# where JUCE's modules are, -DJUCE_MODULES_GLOBAL_PATH=<path> for another copy
+set(JUCE_MODULES_GLOBAL_PATH "/home/aik2/JUCE/modules/" CACHE PATH
+  "The directory that holds JUCE's modules"
+)
+
+
+# the plugin's sources, for the tools that host its processor
+macro(simpleeq_plugin_files group)
+  jucer_project_files("${group}"
+  # Compile   Xcode     Binary    File
+  #           Resource  Resource
+    x         .         .         "../Source/PluginProcessor.cpp"
+    .         .         .         "../Source/PluginProcessor.h"
+    x         .         .         "../Source/PluginEditor.cpp"
+    .         .         .         "../Source/PluginEditor.h"
+    x         .         .         "../Source/FilterChain.cpp"
+    .         .         .         "../Source/FilterChain.h"
+    x         .         .         "../Source/ProgramBank.cpp"
+    .         .         .         "../Source/ProgramBank.h"
+    x         .         .         "../Source/SharedImageCache.cpp"
+    .         .         .         "../Source/SharedImageCache.h"
+    x         .         .         "../Source/CoefficientSnapshot.cpp"
+    .         .         .         "../Source/CoefficientSnapshot.h"
+    x         .         .         "../Source/TraceProfiler.cpp"
+    .         .         .         "../Source/TraceProfiler.h"
+    x         .         .         "../Source/Parameters.cpp"
+    .         .         .         "../Source/Parameters.h"
+    x         .         .         "../Source/SvfFilter.cpp"
+    .         .         .         "../Source/SvfFilter.h"
+    x         .         .         "../Source/LevelMeter.cpp"
+    .         .         .         "../Source/LevelMeter.h"
+    x         .         .         "../Source/BiquadDesigner.cpp"
+    .         .         .         "../Source/BiquadDesigner.h"
+    x         .         .         "../Source/PathVerifier.cpp"
+    .         .         .         "../Source/PathVerifier.h"
+    x         .         .         "../Source/ParallelChannelRenderer.cpp"
+    .         .         .         "../Source/ParallelChannelRenderer.h"
+  )
+endmacro()
+
+
+# jucer_project_module() for each module given, from JUCE_MODULES_GLOBAL_PATH, with
+# the options all the projects use
+macro(simpleeq_project_modules)
+  foreach(simpleeq_module IN ITEMS ${ARGN})
+    if(simpleeq_module STREQUAL "juce_core")
+      jucer_project_module(
+        juce_core
+        PATH "${JUCE_MODULES_GLOBAL_PATH}"
+        JUCE_STRICT_REFCOUNTEDPOINTER ON
+      )
+    else()
+      jucer_project_module(
+        ${simpleeq_module}
+        PATH "${JUCE_MODULES_GLOBAL_PATH}"
+      )
+    endif()
+  endforeach()
+endmacro()
+
+
+# The Visual Studio 2019 and Linux Makefile exporters, each with a Debug and a
+# Release configuration. RELEASE_PACKED adds a Release configuration without the
+# cache line separation, to measure what it is worth.
+macro(simpleeq_export_targets)
+  cmake_parse_arguments(simpleeq_export "RELEASE_PACKED" "" "" ${ARGN})
+
+  foreach(simpleeq_exporter IN ITEMS "Visual Studio 2019" "Linux Makefile")
+    if(simpleeq_exporter STREQUAL "Visual Studio 2019")
+      jucer_export_target(
+        "Visual Studio 2019"
+        EXTRA_COMPILER_FLAGS
+          "/bigobj"
+      )
+    else()
+      jucer_export_target(
+        "${simpleeq_exporter}"
+      )
+    endif()
+
+    jucer_export_target_configuration(
+      "${simpleeq_exporter}"
+      NAME "Debug"
+      DEBUG_MODE ON
+    )
+
+    jucer_export_target_configuration(
+      "${simpleeq_exporter}"
+      NAME "Release"
+      DEBUG_MODE OFF
+    )
+
+    if(simpleeq_export_RELEASE_PACKED)
+      jucer_export_target_configuration(
+        "${simpleeq_exporter}"
+        NAME "Release Packed"
+        DEBUG_MODE OFF
+        PREPROCESSOR_DEFINITIONS
+          "SIMPLEEQ_SEPARATE_CACHE_LINES=0"
+      )
+    endif()
+  endforeach()
+endmacro()
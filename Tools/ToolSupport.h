@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    ToolSupport.h
+    What the console tools have in common: reading their options, timing,
+    percentiles and the sample rates they run at.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <vector>
+
+// the rates hosts run at
+constexpr double sampleRates[] = {44100, 48000, 88200, 96000, 192000};
+
+//==============================================================================
+// --name=N, or defaultValue without the option
+inline int getIntOption(const juce::ArgumentList &args, const juce::String &name,
+                        int defaultValue, int minimum = 1) {
+    return args.containsOption(name)
+               ? juce::jmax(minimum, args.getValueForOption(name).getIntValue())
+               : defaultValue;
+}
+
+inline double getDoubleOption(const juce::ArgumentList &args, const juce::String &name,
+                              double defaultValue) {
+    return args.containsOption(name) ? args.getValueForOption(name).getDoubleValue()
+                                     : defaultValue;
+}
+
+//==============================================================================
+inline double ticksToMilliseconds(juce::int64 ticks) {
+    return 1.0e3 * (double)ticks / (double)juce::Time::getHighResolutionTicksPerSecond();
+}
+
+inline double ticksToNanoseconds(juce::int64 ticks) {
+    return 1.0e9 * (double)ticks / (double)juce::Time::getHighResolutionTicksPerSecond();
+}
+
+// how long function() takes, in ms
+template <typename Function> double timeMilliseconds(Function &&function) {
+    auto start = juce::Time::getHighResolutionTicks();
+    function();
+    return ticksToMilliseconds(juce::Time::getHighResolutionTicks() - start);
+}
+
+struct Percentiles {
+    double p50, p90, p99, p999, max;
+
+    explicit Percentiles(std::vector<double> values) {
+        jassert(!values.empty());
+        std::sort(values.begin(), values.end());
+        auto at = [&values](double proportion) {
+            return values[juce::jmin(values.size() - 1, (size_t)(proportion * values.size()))];
+        };
+        p50 = at(0.5);
+        p90 = at(0.9);
+        p99 = at(0.99);
+        p999 = at(0.999);
+        max = values.back();
+    }
+};